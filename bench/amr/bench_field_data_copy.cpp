@@ -0,0 +1,139 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <string>
+
+#include <SAMRAI/hier/Box.h>
+#include <SAMRAI/hier/BoxContainer.h>
+#include <SAMRAI/hier/IntVector.h>
+#include <SAMRAI/hier/Transformation.h>
+#include <SAMRAI/tbox/Dimension.h>
+
+#include "data/field/field.h"
+#include "data/field/field_data.h"
+#include "data/field/field_overlap.h"
+#include "data/grid/gridlayout_impl.h"
+#include "data/ndarray/ndarray_vector.h"
+#include "hybrid/hybrid_quantities.h"
+#include "utilities/point/point.h"
+
+
+// times FieldData::copy between 3D patches of 64^3 cells, either on the whole ghost box of
+// patches sharing the same domain, or on 2 ghost layers filled from a neighbor patch
+
+using namespace PHARE;
+
+namespace
+{
+constexpr std::size_t dim    = 3;
+constexpr int nbrCells       = 64;
+constexpr int nbrGhostLayers = 2;
+
+using FieldT     = Field<NdArrayVector3D<>, HybridQuantity::Scalar>;
+using FieldDataT = FieldData<GridLayoutImplYee<dim, 1>, FieldT>;
+
+SAMRAI::tbox::Dimension const samraiDim{dim};
+
+
+
+SAMRAI::hier::Box makeBox(std::array<int, dim> const& lower, std::array<int, dim> const& upper)
+{
+    SAMRAI::hier::Index samraiLower{samraiDim};
+    SAMRAI::hier::Index samraiUpper{samraiDim};
+    for (auto iDim = 0u; iDim < dim; ++iDim)
+    {
+        samraiLower[iDim] = lower[iDim];
+        samraiUpper[iDim] = upper[iDim];
+    }
+    return SAMRAI::hier::Box{samraiLower, samraiUpper, SAMRAI::hier::BlockId{0}};
+}
+
+
+
+//! patch data of a 64^3 patch whose first cell is at the given AMR index
+std::shared_ptr<FieldDataT> makeFieldData(std::array<int, dim> const& lower,
+                                          std::string const& name)
+{
+    std::array<int, dim> upper;
+    for (auto iDim = 0u; iDim < dim; ++iDim)
+    {
+        upper[iDim] = lower[iDim] + nbrCells - 1;
+    }
+
+    std::array<double, dim> dl{{0.1, 0.1, 0.1}};
+    std::array<uint32, dim> cells{{nbrCells, nbrCells, nbrCells}};
+    Point<double, dim> origin{lower[0] * dl[0], lower[1] * dl[1], lower[2] * dl[2]};
+
+    auto fieldData = std::make_shared<FieldDataT>(
+        makeBox(lower, upper), SAMRAI::hier::IntVector{samraiDim, nbrGhostLayers}, name, dl, cells,
+        origin, HybridQuantity::Scalar::Ex);
+
+    for (auto& value : fieldData->field)
+    {
+        value = 1.;
+    }
+    return fieldData;
+}
+
+
+
+
+void BM_FieldDataCopyWholeBox(benchmark::State& state)
+{
+    auto source      = makeFieldData({{0, 0, 0}}, "source");
+    auto destination = makeFieldData({{0, 0, 0}}, "destination");
+
+    for (auto _ : state)
+    {
+        destination->copy(*source);
+        benchmark::ClobberMemory();
+    }
+
+    auto const nbrNodes = std::distance(destination->field.begin(), destination->field.end());
+    state.SetItemsProcessed(state.iterations() * nbrNodes);
+    state.SetBytesProcessed(state.iterations() * nbrNodes
+                            * static_cast<int64_t>(sizeof(typename FieldT::type)));
+}
+
+
+
+// state.range(0) is the direction of the neighbor patch the ghost layers are copied from
+void BM_FieldDataCopyGhostLayers(benchmark::State& state)
+{
+    auto const direction = static_cast<std::size_t>(state.range(0));
+
+    std::array<int, dim> sourceLower{{0, 0, 0}};
+    sourceLower[direction] = nbrCells;
+
+    auto source      = makeFieldData(sourceLower, "source");
+    auto destination = makeFieldData({{0, 0, 0}}, "destination");
+
+    // ghost layers of the destination on the side of the source
+    std::array<int, dim> lower{{0, 0, 0}};
+    std::array<int, dim> upper{{nbrCells - 1, nbrCells - 1, nbrCells - 1}};
+    lower[direction] = nbrCells;
+    upper[direction] = nbrCells + nbrGhostLayers - 1;
+
+    SAMRAI::hier::BoxContainer ghostLayers{makeBox(lower, upper)};
+    FieldOverlap<dim> overlap{ghostLayers, SAMRAI::hier::Transformation{
+                                               SAMRAI::hier::IntVector::getZero(samraiDim)}};
+
+    for (auto _ : state)
+    {
+        destination->copy(*source, overlap);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * nbrGhostLayers * nbrCells * nbrCells);
+}
+
+} // namespace
+
+
+
+
+BENCHMARK(BM_FieldDataCopyWholeBox)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FieldDataCopyGhostLayers)->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,21 @@
+#include <benchmark/benchmark.h>
+
+#include <SAMRAI/tbox/SAMRAIManager.h>
+#include <SAMRAI/tbox/SAMRAI_MPI.h>
+
+
+int main(int argc, char** argv)
+{
+    SAMRAI::tbox::SAMRAI_MPI::init(&argc, &argv);
+    SAMRAI::tbox::SAMRAIManager::initialize();
+    SAMRAI::tbox::SAMRAIManager::startup();
+
+    ::benchmark::Initialize(&argc, argv);
+    ::benchmark::RunSpecifiedBenchmarks();
+
+    SAMRAI::tbox::SAMRAIManager::shutdown();
+    SAMRAI::tbox::SAMRAIManager::finalize();
+    SAMRAI::tbox::SAMRAI_MPI::finalize();
+
+    return 0;
+}
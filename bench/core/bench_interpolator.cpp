@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+#include "bench_utilities.h"
+#include "data/grid/gridlayout_impl.h"
+#include "data/particles/particle_array.h"
+#include "numerics/interpolator/interpolator.h"
+
+
+// times the interpolation of the electromagnetic fields onto particles for each dimension
+// and interpolation order, on 10^4 to 10^7 particles
+
+using namespace PHARE;
+
+namespace
+{
+template<std::size_t dim, std::size_t interpOrder>
+void BM_Interpolate(benchmark::State& state)
+{
+    using ParticleArrayT = ParticleArray<dim>;
+    using InterpolatorT  = Interpolator<GridLayoutImplYee<dim, interpOrder>>;
+
+    constexpr int nbrCells  = bench::nbrCellsPerDim<dim>();
+    auto const nbrParticles = static_cast<std::size_t>(state.range(0));
+
+    bench::UniformElectromag<dim> electromag{nbrCells};
+    ParticleArrayT particles;
+    bench::loadRandomParticles(particles, nbrParticles, nbrCells);
+    InterpolatorT interpolator;
+
+    for (auto _ : state)
+    {
+        interpolator(std::begin(particles), std::end(particles), electromag.em);
+        benchmark::ClobberMemory();
+    }
+
+    bench::setParticleCounters(state, nbrParticles, sizeof(typename ParticleArrayT::value_type));
+}
+
+} // namespace
+
+
+
+
+BENCHMARK_TEMPLATE(BM_Interpolate, 1, 1)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_Interpolate, 1, 2)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_Interpolate, 1, 3)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_Interpolate, 2, 1)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_Interpolate, 2, 2)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_Interpolate, 2, 3)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_Interpolate, 3, 1)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_Interpolate, 3, 2)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_Interpolate, 3, 3)->Apply(bench::particleCounts);
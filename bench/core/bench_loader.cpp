@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+
+#include "bench_utilities.h"
+#include "data/grid/gridlayout.h"
+#include "data/grid/gridlayout_impl.h"
+#include "data/ions/particle_initializers/fluid_particle_initializer.h"
+#include "data/particles/particle_array.h"
+#include "utilities/function/function.h"
+#include "utilities/point/point.h"
+
+
+// times FluidParticleInitializer::loadParticles() for each dimension and interpolation order.
+// The number of particles per cell is fixed and the number of cells of the layout is chosen
+// so that 10^4 to 10^7 particles are loaded.
+
+using namespace PHARE;
+
+namespace
+{
+constexpr uint32 nbrParticlesPerCell = 100;
+
+
+template<std::size_t dim, std::size_t interpOrder>
+void BM_LoadParticles(benchmark::State& state)
+{
+    using ParticleArrayT = ParticleArray<dim>;
+    using GridLayoutT    = GridLayout<GridLayoutImplYee<dim, interpOrder>>;
+    using InitializerT   = FluidParticleInitializer<ParticleArrayT, GridLayoutT>;
+
+    auto const nbrCellsInTotal = static_cast<double>(state.range(0)) / nbrParticlesPerCell;
+    auto const nbrCells
+        = std::max(1u, static_cast<uint32>(std::lround(std::pow(nbrCellsInTotal, 1. / dim))));
+
+    std::array<double, dim> meshSize;
+    std::array<uint32, dim> cells;
+    meshSize.fill(0.1);
+    cells.fill(nbrCells);
+    GridLayoutT layout{meshSize, cells, Point<double, dim>{}};
+
+    InitializerT initializer{
+        std::make_unique<ScalarFunction<dim>>([](auto...) { return 1.; }),
+        std::make_unique<VectorFunction<dim>>(
+            [](auto...) { return std::array<double, 3>{{1., 0., 0.}}; }),
+        std::make_unique<VectorFunction<dim>>(
+            [](auto...) { return std::array<double, 3>{{0.2, 0.2, 0.2}}; }),
+        1., nbrParticlesPerCell};
+
+    ParticleArrayT particles;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        particles.clear();
+        state.ResumeTiming();
+
+        initializer.loadParticles(particles, layout);
+        benchmark::ClobberMemory();
+    }
+
+    bench::setParticleCounters(state, particles.size(),
+                               sizeof(typename ParticleArrayT::value_type));
+}
+
+} // namespace
+
+
+
+
+BENCHMARK_TEMPLATE(BM_LoadParticles, 1, 1)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_LoadParticles, 1, 2)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_LoadParticles, 1, 3)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_LoadParticles, 2, 1)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_LoadParticles, 2, 2)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_LoadParticles, 2, 3)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_LoadParticles, 3, 1)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_LoadParticles, 3, 2)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_LoadParticles, 3, 3)->Apply(bench::particleCounts);
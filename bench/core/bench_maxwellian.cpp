@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <random>
+
+#include "bench_utilities.h"
+#include "data/ions/particle_initializers/fluid_particle_initializer.h"
+#include "data/ions/particle_initializers/maxwellian_sampler.h"
+#include "utilities/random/philox.h"
+
+
+// times the drawing of Maxwellian velocities, either one particle at a time from a
+// std::mt19937_64 with maxwellianVelocity(), or by blocks with MaxwellianSampler, with and
+// without the rotation from the local magnetic basis.
+
+using namespace PHARE;
+
+namespace
+{
+std::array<double, 3> const V{{1., 0., 0.}};
+std::array<double, 3> const Vth{{0.2, 0.2, 0.2}};
+
+constexpr uint32 nbrDraws = 3;
+
+
+
+void BM_MaxwellianVelocity(benchmark::State& state)
+{
+    auto const nbrParticles = static_cast<std::size_t>(state.range(0));
+
+    std::mt19937_64 generator{1};
+    std::array<double, 3> velocity;
+
+    for (auto _ : state)
+    {
+        for (std::size_t iPart = 0; iPart < nbrParticles; ++iPart)
+        {
+            maxwellianVelocity(V, Vth, generator, velocity);
+            benchmark::DoNotOptimize(velocity);
+        }
+    }
+
+    bench::setParticleCounters(state, nbrParticles, sizeof(velocity));
+}
+
+
+
+void BM_MaxwellianSampler(benchmark::State& state)
+{
+    auto const nbrParticles = static_cast<std::size_t>(state.range(0));
+    bool const rotate       = state.range(1) != 0;
+
+    std::array<std::array<double, 3>, 3> basis;
+    localMagneticBasis({{1., 1., 1.}}, basis);
+
+    MaxwellianSampler sampler{Philox4x32{uint64{1}}};
+    MaxwellianSampler::VelocityBlock velocities;
+
+    Philox4x32::counter_type const counter{{0, 0, 0, 0}};
+
+    for (auto _ : state)
+    {
+        for (std::size_t blockStart = 0; blockStart < nbrParticles;
+             blockStart += MaxwellianSampler::blockSize)
+        {
+            auto const blockSize
+                = std::min(MaxwellianSampler::blockSize, nbrParticles - blockStart);
+
+            sampler(counter, static_cast<uint32>(blockStart) * nbrDraws, nbrDraws, blockSize, V,
+                    Vth, velocities);
+
+            if (rotate)
+            {
+                MaxwellianSampler::rotate(basis, blockSize, velocities);
+            }
+            benchmark::DoNotOptimize(velocities);
+        }
+    }
+
+    bench::setParticleCounters(state, nbrParticles, sizeof(std::array<double, 3>));
+}
+
+
+
+//! particle counts of bench::particleCounts, without and with rotation
+void samplerArgs(benchmark::internal::Benchmark* bm)
+{
+    for (int nbrParticles = 10000; nbrParticles <= 10000000; nbrParticles *= 10)
+    {
+        bm->Args({nbrParticles, 0});
+        bm->Args({nbrParticles, 1});
+    }
+    bm->Unit(benchmark::kMillisecond);
+}
+
+} // namespace
+
+
+
+
+BENCHMARK(BM_MaxwellianVelocity)->Apply(bench::particleCounts);
+BENCHMARK(BM_MaxwellianSampler)->Apply(samplerArgs);
@@ -0,0 +1,103 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+#include "bench_utilities.h"
+#include "data/grid/gridlayout_impl.h"
+#include "data/particles/particle_array.h"
+#include "data/particles/particle_array_soa.h"
+#include "numerics/boundary_condition/boundary_condition.h"
+#include "numerics/interpolator/interpolator.h"
+#include "numerics/pusher/boris.h"
+#include "utilities/box/box.h"
+#include "utilities/particle_selector/particle_selector.h"
+#include "utilities/range/range.h"
+
+
+// these benchmarks compare the array-of-structures ParticleArray and the
+// structure-of-arrays ParticleArraySoA on the two kernels that loop over all particles
+
+using namespace PHARE;
+
+namespace
+{
+constexpr std::size_t dim         = 3;
+constexpr std::size_t interpOrder = 1;
+constexpr int nbrCells            = 64;
+
+using GridLayoutT   = GridLayoutImplYee<dim, interpOrder>;
+using InterpolatorT = Interpolator<GridLayoutT>;
+using ElectromagT   = Electromag<bench::UniformElectromag<dim>::vecfield_type>;
+using SelectorT     = ParticleSelector<Box<int, dim>>;
+using BoundaryT     = BoundaryCondition<dim, interpOrder>;
+
+
+template<typename ParticleArrayT>
+void BM_InterpolateLayout(benchmark::State& state)
+{
+    auto const nbrParticles = static_cast<std::size_t>(state.range(0));
+
+    bench::UniformElectromag<dim> electromag{nbrCells};
+    ParticleArrayT particles;
+    bench::loadRandomParticles(particles, nbrParticles, nbrCells);
+    InterpolatorT interpolator;
+
+    for (auto _ : state)
+    {
+        interpolator(std::begin(particles), std::end(particles), electromag.em);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * nbrParticles));
+}
+
+
+
+
+template<typename ParticleArrayT>
+void BM_BorisMoveLayout(benchmark::State& state)
+{
+    auto const nbrParticles = static_cast<std::size_t>(state.range(0));
+
+    bench::UniformElectromag<dim> electromag{nbrCells};
+    ParticleArrayT particles;
+    bench::loadRandomParticles(particles, nbrParticles, nbrCells);
+    InterpolatorT interpolator;
+
+    BorisPusher<dim, typename ParticleArrayT::iterator, ElectromagT, InterpolatorT, SelectorT,
+                BoundaryT>
+        pusher;
+    pusher.setMeshAndTimeStep({{0.1, 0.1, 0.1}}, 0.001);
+
+    SelectorT selector{Box<int, dim>{Point<int, dim>{0, 0, 0},
+                                     Point<int, dim>{nbrCells - 1, nbrCells - 1, nbrCells - 1}}};
+
+    for (auto _ : state)
+    {
+        auto rangeIn  = makeRange(std::begin(particles), std::end(particles));
+        auto rangeOut = makeRange(std::begin(particles), std::end(particles));
+        benchmark::DoNotOptimize(
+            pusher.move(rangeIn, rangeOut, electromag.em, 1., interpolator, selector));
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * nbrParticles));
+}
+
+} // namespace
+
+
+
+
+BENCHMARK_TEMPLATE(BM_InterpolateLayout, ParticleArray<dim>)
+    ->Arg(10000000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_InterpolateLayout, ParticleArraySoA<dim>)
+    ->Arg(10000000)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_BorisMoveLayout, ParticleArray<dim>)
+    ->Arg(10000000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_BorisMoveLayout, ParticleArraySoA<dim>)
+    ->Arg(10000000)
+    ->Unit(benchmark::kMillisecond);
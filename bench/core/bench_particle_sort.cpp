@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+#include "bench_utilities.h"
+#include "data/grid/gridlayout_impl.h"
+#include "data/particles/particle_array.h"
+#include "data/particles/particle_sort.h"
+#include "numerics/interpolator/interpolator.h"
+
+
+// these benchmarks time the interpolation of the fields onto particles in random order
+// and sorted along the Morton curve of their cells, and the Morton sort itself
+
+using namespace PHARE;
+
+namespace
+{
+constexpr std::size_t dim          = 3;
+constexpr int nbrCells             = bench::nbrCellsPerDim<dim>();
+constexpr std::size_t nbrParticles = 1000000;
+
+
+template<std::size_t interpOrder, bool sorted>
+void BM_InterpolateParticleOrder(benchmark::State& state)
+{
+    using InterpolatorT = Interpolator<GridLayoutImplYee<dim, interpOrder>>;
+
+    bench::UniformElectromag<dim> electromag{nbrCells};
+    ParticleArray<dim> particles;
+    bench::loadRandomParticles(particles, nbrParticles, nbrCells);
+    if (sorted)
+    {
+        sortByMortonOrder(particles);
+    }
+    InterpolatorT interpolator;
+
+    for (auto _ : state)
+    {
+        interpolator(std::begin(particles), std::end(particles), electromag.em);
+        benchmark::ClobberMemory();
+    }
+
+    bench::setParticleCounters(state, nbrParticles, sizeof(Particle<dim>));
+}
+
+
+
+
+void BM_MortonSort(benchmark::State& state)
+{
+    auto const nbrThreads = static_cast<std::size_t>(state.range(0));
+
+    ParticleArray<dim> randomParticles;
+    bench::loadRandomParticles(randomParticles, nbrParticles, nbrCells);
+    ParticleArray<dim> particles;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        particles = randomParticles;
+        state.ResumeTiming();
+
+        sortByMortonOrder(particles, nbrThreads);
+        benchmark::ClobberMemory();
+    }
+
+    bench::setParticleCounters(state, nbrParticles, sizeof(Particle<dim>));
+}
+
+} // namespace
+
+
+
+
+BENCHMARK_TEMPLATE(BM_InterpolateParticleOrder, 1, false)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_InterpolateParticleOrder, 1, true)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_InterpolateParticleOrder, 2, false)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_InterpolateParticleOrder, 2, true)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_InterpolateParticleOrder, 3, false)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_InterpolateParticleOrder, 3, true)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_MortonSort)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
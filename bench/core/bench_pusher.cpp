@@ -0,0 +1,80 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+#include "bench_utilities.h"
+#include "data/grid/gridlayout_impl.h"
+#include "data/particles/particle_array.h"
+#include "numerics/boundary_condition/boundary_condition.h"
+#include "numerics/interpolator/interpolator.h"
+#include "numerics/pusher/boris.h"
+#include "utilities/box/box.h"
+#include "utilities/particle_selector/particle_selector.h"
+#include "utilities/range/range.h"
+
+
+// times BorisPusher::move() for each dimension and interpolation order, on ranges of
+// 10^4 to 10^7 particles pushed in place and all staying in the domain
+
+using namespace PHARE;
+
+namespace
+{
+template<std::size_t dim, std::size_t interpOrder>
+void BM_BorisMove(benchmark::State& state)
+{
+    using ParticleArrayT = ParticleArray<dim>;
+    using InterpolatorT  = Interpolator<GridLayoutImplYee<dim, interpOrder>>;
+    using ElectromagT    = Electromag<typename bench::UniformElectromag<dim>::vecfield_type>;
+    using SelectorT      = ParticleSelector<Box<int, dim>>;
+    using BoundaryT      = BoundaryCondition<dim, interpOrder>;
+
+    constexpr int nbrCells  = bench::nbrCellsPerDim<dim>();
+    auto const nbrParticles = static_cast<std::size_t>(state.range(0));
+
+    bench::UniformElectromag<dim> electromag{nbrCells};
+    ParticleArrayT particles;
+    bench::loadRandomParticles(particles, nbrParticles, nbrCells);
+    InterpolatorT interpolator;
+
+    BorisPusher<dim, typename ParticleArrayT::iterator, ElectromagT, InterpolatorT, SelectorT,
+                BoundaryT>
+        pusher;
+
+    std::array<double, dim> meshSize;
+    meshSize.fill(0.1);
+    pusher.setMeshAndTimeStep(meshSize, 0.001);
+
+    Point<int, dim> lower;
+    Point<int, dim> upper;
+    for (auto iDim = 0u; iDim < dim; ++iDim)
+    {
+        upper[iDim] = nbrCells - 1;
+    }
+    SelectorT selector{Box<int, dim>{lower, upper}};
+
+    for (auto _ : state)
+    {
+        auto rangeIn  = makeRange(std::begin(particles), std::end(particles));
+        auto rangeOut = makeRange(std::begin(particles), std::end(particles));
+        benchmark::DoNotOptimize(
+            pusher.move(rangeIn, rangeOut, electromag.em, 1., interpolator, selector));
+    }
+
+    bench::setParticleCounters(state, nbrParticles, sizeof(typename ParticleArrayT::value_type));
+}
+
+} // namespace
+
+
+
+
+BENCHMARK_TEMPLATE(BM_BorisMove, 1, 1)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_BorisMove, 1, 2)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_BorisMove, 1, 3)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_BorisMove, 2, 1)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_BorisMove, 2, 2)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_BorisMove, 2, 3)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_BorisMove, 3, 1)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_BorisMove, 3, 2)->Apply(bench::particleCounts);
+BENCHMARK_TEMPLATE(BM_BorisMove, 3, 3)->Apply(bench::particleCounts);
@@ -0,0 +1,173 @@
+#ifndef PHARE_BENCH_CORE_BENCH_UTILITIES_H
+#define PHARE_BENCH_CORE_BENCH_UTILITIES_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include "data/electromag/electromag.h"
+#include "data/field/field.h"
+#include "data/ndarray/ndarray_vector.h"
+#include "data/particles/particle.h"
+#include "data/vecfield/vecfield.h"
+#include "hybrid/hybrid_quantities.h"
+
+namespace PHARE
+{
+namespace bench
+{
+    template<std::size_t dim>
+    struct NdArrayOfDim
+    {
+    };
+
+    template<>
+    struct NdArrayOfDim<1>
+    {
+        using type = NdArrayVector1D<>;
+    };
+
+    template<>
+    struct NdArrayOfDim<2>
+    {
+        using type = NdArrayVector2D<>;
+    };
+
+    template<>
+    struct NdArrayOfDim<3>
+    {
+        using type = NdArrayVector3D<>;
+    };
+
+
+
+
+    /** @brief UniformElectromag owns six fields of nbrCells^dim nodes set to a uniform value
+     * and an Electromag pointing to them.
+     */
+    template<std::size_t dim>
+    class UniformElectromag
+    {
+    public:
+        using ndarray_type  = typename NdArrayOfDim<dim>::type;
+        using field_type    = Field<ndarray_type, HybridQuantity::Scalar>;
+        using vecfield_type = VecField<ndarray_type, HybridQuantity>;
+
+        explicit UniformElectromag(std::uint32_t nbrCells)
+            : em{"EM"}
+            , ex{"EM_E_x", HybridQuantity::Scalar::Ex, shape_(nbrCells)}
+            , ey{"EM_E_y", HybridQuantity::Scalar::Ey, shape_(nbrCells)}
+            , ez{"EM_E_z", HybridQuantity::Scalar::Ez, shape_(nbrCells)}
+            , bx{"EM_B_x", HybridQuantity::Scalar::Bx, shape_(nbrCells)}
+            , by{"EM_B_y", HybridQuantity::Scalar::By, shape_(nbrCells)}
+            , bz{"EM_B_z", HybridQuantity::Scalar::Bz, shape_(nbrCells)}
+        {
+            std::fill(std::begin(ex), std::end(ex), 0.01);
+            std::fill(std::begin(ey), std::end(ey), -0.05);
+            std::fill(std::begin(ez), std::end(ez), 0.05);
+            std::fill(std::begin(bx), std::end(bx), 1.);
+            std::fill(std::begin(by), std::end(by), 1.);
+            std::fill(std::begin(bz), std::end(bz), 1.);
+
+            em.E.setBuffer("EM_E_x", &ex);
+            em.E.setBuffer("EM_E_y", &ey);
+            em.E.setBuffer("EM_E_z", &ez);
+            em.B.setBuffer("EM_B_x", &bx);
+            em.B.setBuffer("EM_B_y", &by);
+            em.B.setBuffer("EM_B_z", &bz);
+        }
+
+        Electromag<vecfield_type> em;
+
+    private:
+        field_type ex, ey, ez;
+        field_type bx, by, bz;
+
+        static std::array<std::uint32_t, dim> shape_(std::uint32_t nbrCells)
+        {
+            std::array<std::uint32_t, dim> shape;
+            shape.fill(nbrCells);
+            return shape;
+        }
+    };
+
+
+
+
+    /** @brief fills particles with nbrParticles particles uniformly distributed in
+     * the cells [ghostWidth, nbrCells - ghostWidth[ of each direction, with random velocities.
+     */
+    template<typename ParticleArrayT, std::size_t dim = ParticleArrayT::value_type::dimension>
+    void loadRandomParticles(ParticleArrayT& particles, std::size_t nbrParticles, int nbrCells,
+                             int ghostWidth = 3)
+    {
+        std::mt19937_64 generator{1};
+        std::uniform_int_distribution<int> cell(ghostWidth, nbrCells - ghostWidth - 1);
+        std::uniform_real_distribution<float> delta(0.f, 1.f);
+        std::normal_distribution<double> velocity(0., 0.1);
+
+        particles.clear();
+        particles.reserve(nbrParticles);
+
+        Particle<dim> particle;
+        particle.weight = 1.;
+        particle.charge = 1.;
+
+        for (std::size_t iPart = 0; iPart < nbrParticles; ++iPart)
+        {
+            for (auto iDim = 0u; iDim < dim; ++iDim)
+            {
+                particle.iCell[iDim] = cell(generator);
+                particle.delta[iDim] = delta(generator);
+            }
+            for (auto& v : particle.v)
+            {
+                v = velocity(generator);
+            }
+            particles.push_back(particle);
+        }
+    }
+
+
+
+
+    //! number of cells per direction of the grids used by the particle kernel benchmarks
+    template<std::size_t dim>
+    constexpr int nbrCellsPerDim()
+    {
+        return dim == 1 ? 10000 : (dim == 2 ? 256 : 64);
+    }
+
+
+
+
+    //! particle counts from 10^4 to 10^7 on which particle kernels are timed
+    inline void particleCounts(benchmark::internal::Benchmark* bm)
+    {
+        bm->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMillisecond);
+    }
+
+
+
+
+    /** @brief reports the throughput of a kernel that processed nbrParticles particles
+     * at each iteration, as particles/second, along with the number of bytes a particle
+     * occupies in memory, so that throughputs of different particle layouts can be compared.
+     */
+    inline void setParticleCounters(benchmark::State& state, std::size_t nbrParticles,
+                                    std::size_t bytesPerParticle)
+    {
+        auto const nbrProcessed = static_cast<int64_t>(state.iterations() * nbrParticles);
+
+        state.SetItemsProcessed(nbrProcessed);
+        state.SetBytesProcessed(nbrProcessed * static_cast<int64_t>(bytesPerParticle));
+        state.counters["bytes/particle"] = static_cast<double>(bytesPerParticle);
+    }
+
+} // namespace bench
+} // namespace PHARE
+
+#endif
@@ -9,7 +9,11 @@
 
 #include <SAMRAI/hier/Box.h>
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstddef>
+#include <tuple>
 #include <vector>
 
 
@@ -125,8 +129,8 @@ private:
 
 
 /** @brief Given a dimension, compute the coarsening
- * operation on one coarseIndex, using weights and indexes from
- * the IndexesAndWeights objects
+ * operation on one coarseIndex, or on all the indexes of a box, using weights and indexes
+ * from the IndexesAndWeights objects
  *
  */
 template<std::size_t dimension>
@@ -139,6 +143,7 @@ public:
         : indexesAndWeights_{centering, ratio}
         , sourceBox_{sourceBox}
         , destinationBox_{destinationBox}
+        , ratio_{ratio}
         , weights_{indexesAndWeights_.getWeights()}
     {
     }
@@ -246,13 +251,250 @@ public:
 
 
 
+
+    /** @brief apply the coarsening operation of the fineField to the coarseField at all the
+     * amr indexes of coarseBox. This gives the same values as calling the above operator on
+     * each index of the box, but start indexes are only computed for the lower corner of the
+     * box: the fine start index then moves by ratio fine nodes per coarse node.
+     *
+     * For the common uniform ratios 2 and 4, the weights of each direction are copied into
+     * std::array, so that the stencil loops have compile time bounds and can be unrolled.
+     * Other ratios use the runtime sized weights.
+     */
+    template<typename FieldT>
+    void operator()(FieldT const& fineField, FieldT& coarseField,
+                    SAMRAI::hier::Box const& coarseBox)
+    {
+        TBOX_ASSERT(fineField.physicalQuantities() == coarseField.physicalQuantities());
+
+        if (coarseBox.empty())
+        {
+            return;
+        }
+
+        Point<int, dimension> coarseLower;
+        for (std::size_t iDir = dirX; iDir < dimension; ++iDir)
+        {
+            coarseLower[iDir] = coarseBox.lower(iDir);
+        }
+
+        auto const fineStart
+            = AMRToLocal(indexesAndWeights_.computeStartIndexes(coarseLower), sourceBox_);
+        auto const coarseStart = AMRToLocal(coarseLower, destinationBox_);
+
+        BoxStencil stencil;
+        for (std::size_t iDir = dirX; iDir < dimension; ++iDir)
+        {
+            stencil.fineStart[iDir]   = static_cast<std::size_t>(fineStart[iDir]);
+            stencil.coarseStart[iDir] = static_cast<std::size_t>(coarseStart[iDir]);
+            stencil.nbrNodes[iDir]
+                = static_cast<std::size_t>(coarseBox.upper(iDir) - coarseBox.lower(iDir) + 1);
+            stencil.ratio[iDir] = static_cast<std::size_t>(ratio_(iDir));
+        }
+
+        auto coarsenBox = [&](auto const& weights) {
+            coarsenBox_(fineField, coarseField, stencil, weights);
+        };
+
+        if (isUniformRatio_(2))
+        {
+            withWeights_<2, dirX>(std::tuple<>{}, coarsenBox);
+        }
+        else if (isUniformRatio_(4))
+        {
+            withWeights_<4, dirX>(std::tuple<>{}, coarsenBox);
+        }
+        else
+        {
+            withWeights_<0, dirX>(std::tuple<>{}, coarsenBox);
+        }
+    }
+
+
+
 private:
     IndexesAndWeights<dimension> indexesAndWeights_;
 
     SAMRAI::hier::Box const sourceBox_;
     SAMRAI::hier::Box const destinationBox_;
+    SAMRAI::hier::IntVector const ratio_;
 
     std::array<std::vector<double>, dimension> const& weights_;
+
+
+    //! local start indexes, number of coarse nodes and ratio of each direction of a box
+    struct BoxStencil
+    {
+        std::array<std::size_t, dimension> fineStart;
+        std::array<std::size_t, dimension> coarseStart;
+        std::array<std::size_t, dimension> nbrNodes;
+        std::array<std::size_t, dimension> ratio;
+    };
+
+
+
+    bool isUniformRatio_(int ratio) const
+    {
+        for (std::size_t iDir = dirX; iDir < dimension; ++iDir)
+        {
+            if (ratio_(iDir) != ratio)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+
+
+    /** call fn with a tuple of the weights of all directions. With a non-zero ratio, the
+     * weights of a direction are given as a std::array of ratio or ratio + 1 points, which
+     * is the number of points for the dual and the primal centerings. With ratio 0, they are
+     * given as they are stored.
+     */
+    template<std::size_t ratio, std::size_t iDir, typename Weights, typename Fn>
+    void withWeights_(Weights const& weights, Fn&& fn) const
+    {
+        if constexpr (iDir == dimension)
+        {
+            fn(weights);
+        }
+        else if constexpr (ratio == 0)
+        {
+            withWeights_<ratio, iDir + 1>(std::tuple_cat(weights, std::make_tuple(weights_[iDir])),
+                                          fn);
+        }
+        else
+        {
+            if (weights_[iDir].size() == ratio)
+            {
+                withWeights_<ratio, iDir + 1>(
+                    std::tuple_cat(weights, std::make_tuple(toArray_<ratio>(weights_[iDir]))), fn);
+            }
+            else
+            {
+                withWeights_<ratio, iDir + 1>(
+                    std::tuple_cat(weights, std::make_tuple(toArray_<ratio + 1>(weights_[iDir]))),
+                    fn);
+            }
+        }
+    }
+
+
+
+    template<std::size_t nbrPoints>
+    static std::array<double, nbrPoints> toArray_(std::vector<double> const& weights)
+    {
+        std::array<double, nbrPoints> array;
+        std::copy_n(std::begin(weights), nbrPoints, std::begin(array));
+        return array;
+    }
+
+
+
+    template<typename FieldT, typename Weights>
+    static void coarsenBox_(FieldT const& fineField, FieldT& coarseField,
+                            BoxStencil const& stencil, Weights const& weights)
+    {
+        auto const& xWeights = std::get<dirX>(weights);
+
+        if constexpr (dimension == 1)
+        {
+            for (std::size_t ix = 0; ix < stencil.nbrNodes[dirX]; ++ix)
+            {
+                auto const xStartIndex = stencil.fineStart[dirX] + ix * stencil.ratio[dirX];
+
+                double coarseValue = 0.;
+                for (std::size_t iShiftX = 0; iShiftX < xWeights.size(); ++iShiftX)
+                {
+                    coarseValue += fineField(xStartIndex + iShiftX) * xWeights[iShiftX];
+                }
+
+                coarseField(stencil.coarseStart[dirX] + ix) = coarseValue;
+            }
+        }
+
+
+
+        else if constexpr (dimension == 2)
+        {
+            auto const& yWeights = std::get<dirY>(weights);
+
+            for (std::size_t ix = 0; ix < stencil.nbrNodes[dirX]; ++ix)
+            {
+                auto const xStartIndex = stencil.fineStart[dirX] + ix * stencil.ratio[dirX];
+
+                for (std::size_t iy = 0; iy < stencil.nbrNodes[dirY]; ++iy)
+                {
+                    auto const yStartIndex = stencil.fineStart[dirY] + iy * stencil.ratio[dirY];
+
+                    double coarseValue = 0.;
+                    for (std::size_t iShiftX = 0; iShiftX < xWeights.size(); ++iShiftX)
+                    {
+                        double Yinterp = 0.;
+                        for (std::size_t iShiftY = 0; iShiftY < yWeights.size(); ++iShiftY)
+                        {
+                            Yinterp += fineField(xStartIndex + iShiftX, yStartIndex + iShiftY)
+                                       * yWeights[iShiftY];
+                        }
+                        coarseValue += Yinterp * xWeights[iShiftX];
+                    }
+
+                    coarseField(stencil.coarseStart[dirX] + ix, stencil.coarseStart[dirY] + iy)
+                        = coarseValue;
+                }
+            }
+        }
+
+
+
+        else if constexpr (dimension == 3)
+        {
+            auto const& yWeights = std::get<dirY>(weights);
+            auto const& zWeights = std::get<dirZ>(weights);
+
+            for (std::size_t ix = 0; ix < stencil.nbrNodes[dirX]; ++ix)
+            {
+                auto const xStartIndex = stencil.fineStart[dirX] + ix * stencil.ratio[dirX];
+
+                for (std::size_t iy = 0; iy < stencil.nbrNodes[dirY]; ++iy)
+                {
+                    auto const yStartIndex = stencil.fineStart[dirY] + iy * stencil.ratio[dirY];
+
+                    for (std::size_t iz = 0; iz < stencil.nbrNodes[dirZ]; ++iz)
+                    {
+                        auto const zStartIndex
+                            = stencil.fineStart[dirZ] + iz * stencil.ratio[dirZ];
+
+                        double coarseValue = 0.;
+                        for (std::size_t iShiftX = 0; iShiftX < xWeights.size(); ++iShiftX)
+                        {
+                            double Yinterp = 0.;
+                            for (std::size_t iShiftY = 0; iShiftY < yWeights.size(); ++iShiftY)
+                            {
+                                double Zinterp = 0.;
+                                for (std::size_t iShiftZ = 0; iShiftZ < zWeights.size();
+                                     ++iShiftZ)
+                                {
+                                    Zinterp += fineField(xStartIndex + iShiftX,
+                                                         yStartIndex + iShiftY,
+                                                         zStartIndex + iShiftZ)
+                                               * zWeights[iShiftZ];
+                                }
+                                Yinterp += Zinterp * yWeights[iShiftY];
+                            }
+                            coarseValue += Yinterp * xWeights[iShiftX];
+                        }
+
+                        coarseField(stencil.coarseStart[dirX] + ix,
+                                    stencil.coarseStart[dirY] + iy,
+                                    stencil.coarseStart[dirZ] + iz)
+                            = coarseValue;
+                    }
+                }
+            }
+        }
+    }
 };
 
 
@@ -71,8 +71,7 @@ public:
      * get the Field and GridLayout encapsulated into the fieldData.
      * With the help of FieldGeometry, transform the coarseBox to the correct index.
      * After that we can now create FieldCoarsen with the indexAndWeight implementation selected.
-     * Finnaly loop over the indexes in the box, and apply the coarsening defined in FieldCoarsen
-     * operator
+     * Finnaly apply the coarsening defined in FieldCoarsen to the whole intersection box
      *
      */
     void coarsen(SAMRAI::hier::Patch& destinationPatch, SAMRAI::hier::Patch const& sourcePatch,
@@ -131,56 +130,8 @@ public:
         CoarsenField<dimension> coarsenIt{destinationLayout.centering(qty), sourceBox,
                                           destinationBox, ratio};
 
-        // now we can loop over the intersection box
-
-        Point<int, dimension> startIndex;
-        Point<int, dimension> endIndex;
-
-        startIndex[dirX] = intersectionBox.lower(dirX);
-        endIndex[dirX]   = intersectionBox.upper(dirX);
-
-        if constexpr (dimension > 1)
-        {
-            startIndex[dirY] = intersectionBox.lower[dirY];
-            endIndex[dirY]   = intersectionBox.upper[dirY];
-        }
-        if constexpr (dimension > 2)
-        {
-            startIndex[dirZ] = intersectionBox.lower[dirZ];
-            endIndex[dirZ]   = intersectionBox.upper[dirZ];
-        }
-
-        if constexpr (dimension == 1)
-        {
-            for (int ix = startIndex[dirX]; ix <= endIndex[dirX]; ++ix)
-            {
-                coarsenIt(sourceField, destinationField, {{ix}});
-            }
-        }
-        else if constexpr (dimension == 2)
-        {
-            for (int ix = startIndex[dirX]; ix <= endIndex[dirX]; ++ix)
-            {
-                for (int iy = startIndex[dirY]; iy <= endIndex[dirY]; ++iy)
-                {
-                    coarsenIt(sourceField, destinationField, {{ix, iy}});
-                }
-            }
-        }
-        else if constexpr (dimension == 3)
-        {
-            for (int ix = startIndex[dirX]; ix <= endIndex[dirX]; ++ix)
-            {
-                for (int iy = startIndex[dirY]; iy <= endIndex[dirY]; ++iy)
-                {
-                    for (int iz = startIndex[dirZ]; iz <= endIndex[dirZ]; ++iz)
-
-                    {
-                        coarsenIt(sourceField, destinationField, {{ix, iy, iz}});
-                    }
-                }
-            }
-        }
+        // and coarsen all the indexes of the intersection box at once
+        coarsenIt(sourceField, destinationField, intersectionBox);
     }
 };
 } // namespace PHARE
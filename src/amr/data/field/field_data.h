@@ -3,6 +3,10 @@
 
 #include <SAMRAI/hier/PatchData.h>
 #include <SAMRAI/tbox/MemoryUtilities.h>
+#include <SAMRAI/tbox/MessageStream.h>
+
+#include <algorithm>
+#include <cstddef>
 #include <utility>
 
 #include "data/grid/gridlayout.h"
@@ -196,15 +200,14 @@ public:
 
     /*** \brief Serialize the data contained in the field data on the region covered by the overlap,
      * and put it on the stream.
+     *
+     * Rows of the field along its last (contiguous) dimension are packed directly from the
+     * field storage into the stream, without intermediate buffer. Streams given by SAMRAI
+     * schedules are sized with getDataStreamSize() beforehand.
      */
     void packStream(SAMRAI::tbox::MessageStream& stream,
                     const SAMRAI::hier::BoxOverlap& overlap) const final
     {
-        // getDataStreamSize_<true> mean that we want to apply the transformation
-        size_t expectedSize = getDataStreamSize_<true>(overlap) / sizeof(double);
-        std::vector<typename FieldImpl::type> buffer;
-        buffer.reserve(expectedSize);
-
         auto fieldOverlap = dynamic_cast<FieldOverlap<dimension> const*>(&overlap);
         TBOX_ASSERT(fieldOverlap != nullptr);
 
@@ -231,13 +234,10 @@ public:
                 packBox = packBox * sourceBox;
 
 
-                internals_.packImpl(buffer, source, packBox, sourceBox);
+                internals_.packImpl(stream, source, packBox, sourceBox);
             }
         }
         // throw, we don't do rotations in phare....
-
-        // Once we have fill the buffer, we send it on the stream
-        stream.pack(buffer.data(), buffer.size());
     }
 
 
@@ -245,25 +245,16 @@ public:
 
     /*** \brief Unserialize data contained on the stream, that comes from a region covered by the
      * overlap, and fill the data where is needed.
+     *
+     * Rows are unpacked from the stream directly into the field storage, in the order
+     * packStream() wrote them.
      */
     void unpackStream(SAMRAI::tbox::MessageStream& stream,
                       const SAMRAI::hier::BoxOverlap& overlap) final
     {
-        // For unpacking we need to know how much element we will need to
-        // extract
-        size_t expectedSize = getDataStreamSize(overlap) / sizeof(double);
-        // Here the seek counter will be used to index buffer
-        size_t seek = 0;
-        std::vector<double> buffer;
-        buffer.resize(expectedSize, 0.);
-
         auto fieldOverlap = dynamic_cast<FieldOverlap<dimension> const*>(&overlap);
         TBOX_ASSERT(fieldOverlap != nullptr);
 
-
-        // We flush a portion of the stream on the buffer.
-        stream.unpack(buffer.data(), expectedSize);
-
         SAMRAI::hier::Transformation const& transformation = fieldOverlap->getTransformation();
         if (transformation.getRotation() == SAMRAI::hier::Transformation::NO_ROTATE)
         {
@@ -283,7 +274,7 @@ public:
                 SAMRAI::hier::Box packBox{box * destination};
 
 
-                internals_.unpackImpl(seek, buffer, source, packBox, destination);
+                internals_.unpackImpl(stream, source, packBox, destination);
             }
         }
     }
@@ -449,6 +440,51 @@ private:
 
 
 
+/** RowCopy copies rows of a field, i.e. runs of elements along its last dimension that are
+ * contiguous in memory. A row that directly follows the previous one in both the source and
+ * the destination (e.g. when the copied box spans the whole last dimension of both fields)
+ * is merged with it, so that the copy is done in as few blocks as possible.
+ *
+ * Pending rows are copied by flush(), which must be called once all rows are given.
+ */
+template<typename DataType>
+class RowCopy
+{
+public:
+    void operator()(DataType const* source, DataType* destination, std::size_t size)
+    {
+        if (size_ > 0 && source == source_ + size_ && destination == destination_ + size_)
+        {
+            size_ += size;
+            return;
+        }
+
+        flush();
+        source_      = source;
+        destination_ = destination;
+        size_        = size;
+    }
+
+
+    void flush()
+    {
+        if (size_ > 0)
+        {
+            std::copy(source_, source_ + size_, destination_);
+        }
+        size_ = 0;
+    }
+
+
+private:
+    DataType const* source_{nullptr};
+    DataType* destination_{nullptr};
+    std::size_t size_{0};
+};
+
+
+
+
 // 1D internals implementation
 template<typename GridLayoutImpl, typename FieldImpl, typename PhysicalQuantity>
 class FieldDataInternals<GridLayoutImpl, 1, FieldImpl, PhysicalQuantity>
@@ -463,41 +499,44 @@ public:
         uint32 xSourceEnd      = static_cast<uint32>(localSourceBox.upper(0));
         uint32 xDestinationEnd = static_cast<uint32>(localDestinationBox.upper(0));
 
-        for (uint32 xSource = xSourceStart, xDestination = xDestinationStart;
-             xSource <= xSourceEnd && xDestination <= xDestinationEnd; ++xSource, ++xDestination)
+        if (xSourceEnd < xSourceStart || xDestinationEnd < xDestinationStart)
         {
-            destination(xDestination) = source(xSource);
+            return;
         }
+
+        auto const size
+            = std::min(xSourceEnd - xSourceStart, xDestinationEnd - xDestinationStart) + 1;
+
+        std::copy_n(&source(xSourceStart), size, &destination(xDestinationStart));
     }
 
 
 
 
-    void packImpl(std::vector<double>& buffer, FieldImpl const& source,
+    void packImpl(SAMRAI::tbox::MessageStream& stream, FieldImpl const& source,
                   SAMRAI::hier::Box const& overlap, SAMRAI::hier::Box const& destination) const
     {
         int xStart = overlap.lower(0) - destination.lower(0);
         int xEnd   = overlap.upper(0) - destination.lower(0);
 
-        for (int xi = xStart; xi <= xEnd; ++xi)
+        if (xEnd >= xStart)
         {
-            buffer.push_back(source(xi));
+            stream.pack(&source(xStart), static_cast<size_t>(xEnd - xStart + 1));
         }
     }
 
 
 
 
-    void unpackImpl(size_t& seek, std::vector<double> const& buffer, FieldImpl& source,
+    void unpackImpl(SAMRAI::tbox::MessageStream& stream, FieldImpl& source,
                     SAMRAI::hier::Box const& overlap, SAMRAI::hier::Box const& destination) const
     {
         int xStart = overlap.lower(0) - destination.lower(0);
         int xEnd   = overlap.upper(0) - destination.lower(0);
 
-        for (int xi = xStart; xi <= xEnd; ++xi)
+        if (xEnd >= xStart)
         {
-            source(xi) = buffer[seek];
-            ++seek;
+            stream.unpack(&source(xStart), static_cast<size_t>(xEnd - xStart + 1));
         }
     }
 };
@@ -524,24 +563,32 @@ public:
         uint32 ySourceEnd      = static_cast<uint32>(localSourceBox.upper(1));
         uint32 yDestinationEnd = static_cast<uint32>(localDestinationBox.upper(1));
 
+        if (ySourceEnd < ySourceStart || yDestinationEnd < yDestinationStart)
+        {
+            return;
+        }
+
+        // rows along y are contiguous and copied as blocks
+        auto const rowSize
+            = std::min(ySourceEnd - ySourceStart, yDestinationEnd - yDestinationStart) + 1;
+
+        RowCopy<typename FieldImpl::type> copyRow;
+
         for (uint32 xSource = xSourceStart, xDestination = xDestinationStart;
              xSource <= xSourceEnd && xDestination <= xDestinationEnd; ++xSource, ++xDestination)
         {
-            for (uint32 ySource = ySourceStart, yDestination = yDestinationStart;
-                 ySource <= ySourceEnd && yDestination <= yDestinationEnd;
-                 ++ySource, ++yDestination)
-            {
-                destination(xDestination, yDestination) = source(xSource, ySource);
-            }
+            copyRow(&source(xSource, ySourceStart), &destination(xDestination, yDestinationStart),
+                    rowSize);
         }
+        copyRow.flush();
     }
 
 
 
 
-    void packImpl(std::vector<double>& buffer, FieldImpl const& source,
+    // y is the contiguous direction of the field, so each row along y is packed at once
+    void packImpl(SAMRAI::tbox::MessageStream& stream, FieldImpl const& source,
                   SAMRAI::hier::Box const& overlap, SAMRAI::hier::Box const& destination) const
-
     {
         int xStart = overlap.lower(0) - destination.lower(0);
         int xEnd   = overlap.upper(0) - destination.lower(0);
@@ -549,19 +596,22 @@ public:
         int yStart = overlap.lower(1) - destination.lower(1);
         int yEnd   = overlap.upper(1) - destination.lower(1);
 
+        if (yEnd < yStart)
+        {
+            return;
+        }
+        auto const rowSize = static_cast<size_t>(yEnd - yStart + 1);
+
         for (int xi = xStart; xi <= xEnd; ++xi)
         {
-            for (int yi = yStart; yi <= yEnd; ++yi)
-            {
-                buffer.push_back(source(xi, yi));
-            }
+            stream.pack(&source(xi, yStart), rowSize);
         }
     }
 
 
 
 
-    void unpackImpl(size_t& seek, std::vector<double> const& buffer, FieldImpl& source,
+    void unpackImpl(SAMRAI::tbox::MessageStream& stream, FieldImpl& source,
                     SAMRAI::hier::Box const& overlap, SAMRAI::hier::Box const& destination) const
     {
         int xStart = overlap.lower(0) - destination.lower(0);
@@ -570,13 +620,15 @@ public:
         int yStart = overlap.lower(1) - destination.lower(1);
         int yEnd   = overlap.upper(1) - destination.lower(1);
 
+        if (yEnd < yStart)
+        {
+            return;
+        }
+        auto const rowSize = static_cast<size_t>(yEnd - yStart + 1);
+
         for (int xi = xStart; xi <= xEnd; ++xi)
         {
-            for (int yi = yStart; yi <= yEnd; ++yi)
-            {
-                source(xi, yi) = buffer[seek];
-                ++seek;
-            }
+            stream.unpack(&source(xi, yStart), rowSize);
         }
     }
 };
@@ -609,6 +661,17 @@ public:
         uint32 zSourceEnd      = static_cast<uint32>(localSourceBox.upper(2));
         uint32 zDestinationEnd = static_cast<uint32>(localDestinationBox.upper(2));
 
+        if (zSourceEnd < zSourceStart || zDestinationEnd < zDestinationStart)
+        {
+            return;
+        }
+
+        // rows along z are contiguous and copied as blocks
+        auto const rowSize
+            = std::min(zSourceEnd - zSourceStart, zDestinationEnd - zDestinationStart) + 1;
+
+        RowCopy<typename FieldImpl::type> copyRow;
+
         for (uint32 xSource = xSourceStart, xDestination = xDestinationStart;
              xSource <= xSourceEnd && xDestination <= xDestinationEnd; ++xSource, ++xDestination)
         {
@@ -616,21 +679,18 @@ public:
                  ySource <= ySourceEnd && yDestination <= yDestinationEnd;
                  ++ySource, ++yDestination)
             {
-                for (uint32 zSource = zSourceStart, zDestination = zDestinationStart;
-                     zSource <= zSourceEnd && zDestination <= zDestinationEnd;
-                     ++zSource, ++zDestination)
-                {
-                    destination(xDestination, yDestination, zDestination)
-                        = source(xSource, ySource, zSource);
-                }
+                copyRow(&source(xSource, ySource, zSourceStart),
+                        &destination(xDestination, yDestination, zDestinationStart), rowSize);
             }
         }
+        copyRow.flush();
     }
 
 
 
 
-    void packImpl(std::vector<double>& buffer, FieldImpl const& source,
+    // z is the contiguous direction of the field, so each row along z is packed at once
+    void packImpl(SAMRAI::tbox::MessageStream& stream, FieldImpl const& source,
                   SAMRAI::hier::Box const& overlap, SAMRAI::hier::Box const& destination) const
     {
         int xStart = overlap.lower(0) - destination.lower(0);
@@ -642,14 +702,17 @@ public:
         int zStart = overlap.lower(2) - destination.lower(2);
         int zEnd   = overlap.upper(2) - destination.lower(2);
 
+        if (zEnd < zStart)
+        {
+            return;
+        }
+        auto const rowSize = static_cast<size_t>(zEnd - zStart + 1);
+
         for (int xi = xStart; xi <= xEnd; ++xi)
         {
             for (int yi = yStart; yi <= yEnd; ++yi)
             {
-                for (int zi = zStart; zi <= zEnd; ++zi)
-                {
-                    buffer.push_back(source(xi, yi, zi));
-                }
+                stream.pack(&source(xi, yi, zStart), rowSize);
             }
         }
     }
@@ -657,7 +720,7 @@ public:
 
 
 
-    void unpackImpl(size_t& seek, std::vector<double> const& buffer, FieldImpl& source,
+    void unpackImpl(SAMRAI::tbox::MessageStream& stream, FieldImpl& source,
                     SAMRAI::hier::Box const& overlap, SAMRAI::hier::Box const& destination) const
     {
         int xStart = overlap.lower(0) - destination.lower(0);
@@ -669,15 +732,17 @@ public:
         int zStart = overlap.lower(2) - destination.lower(2);
         int zEnd   = overlap.upper(2) - destination.lower(2);
 
+        if (zEnd < zStart)
+        {
+            return;
+        }
+        auto const rowSize = static_cast<size_t>(zEnd - zStart + 1);
+
         for (int xi = xStart; xi <= xEnd; ++xi)
         {
             for (int yi = yStart; yi <= yEnd; ++yi)
             {
-                for (int zi = zStart; zi <= zEnd; ++zi)
-                {
-                    source(xi, yi, zi) = buffer[seek];
-                    ++seek;
-                }
+                stream.unpack(&source(xi, yi, zStart), rowSize);
             }
         }
     }
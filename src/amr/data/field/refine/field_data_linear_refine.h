@@ -97,57 +97,11 @@ public:
         for (auto const& box : destinationBoxes)
         {
             // we compute the intersection with the destination,
-            // and then we apply the refine operation on each fine
-            // index.
+            // and then we apply the refine operation on all the fine
+            // indexes of the intersection.
             auto intersectionBox = destinationFieldBox * box;
 
-            if constexpr (dimension == 1)
-            {
-                int iStartX = intersectionBox.lower(dirX);
-                int iEndX   = intersectionBox.upper(dirX);
-
-                for (int ix = iStartX; ix <= iEndX; ++ix)
-                {
-                    refineIt(sourceField, destinationField, {{ix}});
-                }
-            }
-            else if constexpr (dimension == 2)
-            {
-                int iStartX = intersectionBox.lower(dirX);
-                int iStartY = intersectionBox.lower(dirY);
-
-                int iEndX = intersectionBox.upper(dirX);
-                int iEndY = intersectionBox.upper(dirY);
-
-                for (int ix = iStartX; ix <= iEndX; ++ix)
-                {
-                    for (int iy = iStartY; iy <= iEndY; ++iy)
-                    {
-                        refineIt(sourceField, destinationField, {{ix, iy}});
-                    }
-                }
-            }
-            else if constexpr (dimension == 3)
-            {
-                int iStartX = intersectionBox.lower(dirX);
-                int iStartY = intersectionBox.lower(dirY);
-                int iStartZ = intersectionBox.lower(dirZ);
-
-                int iEndX = intersectionBox.upper(dirX);
-                int iEndY = intersectionBox.upper(dirY);
-                int iEndZ = intersectionBox.upper(dirZ);
-
-                for (int ix = iStartX; ix <= iEndX; ++ix)
-                {
-                    for (int iy = iStartY; iy <= iEndY; ++iy)
-                    {
-                        for (int iz = iStartZ; iz <= iEndZ; ++iz)
-                        {
-                            refineIt(sourceField, destinationField, {{ix, iy, iz}});
-                        }
-                    }
-                }
-            }
+            refineIt(sourceField, destinationField, intersectionBox);
         }
     }
 };
@@ -1,5 +1,9 @@
 #include "field_linear_refine.h"
 
+#include <map>
+#include <mutex>
+#include <utility>
+
 using namespace PHARE;
 
 UniformIntervalPartitionWeight::UniformIntervalPartitionWeight(QtyCentering centering, int ratio,
@@ -46,3 +50,46 @@ UniformIntervalPartitionWeight::UniformIntervalPartitionWeight(QtyCentering cent
         }
     }
 }
+
+
+
+
+std::vector<std::array<double, 2>> const& PHARE::linearRefineWeights(QtyCentering centering,
+                                                                     int ratio)
+{
+    static std::map<std::pair<QtyCentering, int>, std::vector<std::array<double, 2>>> tables;
+    static std::mutex tablesMutex;
+
+    std::lock_guard<std::mutex> lock{tablesMutex};
+
+    auto const key   = std::make_pair(centering, ratio);
+    auto const found = tables.find(key);
+    if (found != std::end(tables))
+    {
+        return found->second;
+    }
+
+    // The number of points depends on the centering, for primal or odd ratio
+    // it is ratio + 1 , for dual with evenRatio it is ratio
+    bool const evenRatio = ratio % 2 == 0;
+
+    std::size_t nbrPoints = static_cast<std::size_t>(ratio);
+    if (centering == QtyCentering::primal || !evenRatio)
+    {
+        nbrPoints += 1;
+    }
+
+    // here we extract the distances of the left index
+    // and then compute the weights : 1.-distance for the left one
+    // and distance for the right index
+    UniformIntervalPartitionWeight distances{centering, ratio, nbrPoints};
+
+    std::vector<std::array<double, 2>> weights;
+    weights.reserve(distances.getUniformDistances().size());
+    for (auto const& distance : distances.getUniformDistances())
+    {
+        weights.emplace_back(std::array<double, 2>{{1. - distance, distance}});
+    }
+
+    return tables.emplace(key, std::move(weights)).first->second;
+}
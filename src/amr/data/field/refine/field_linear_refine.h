@@ -10,6 +10,8 @@
 #include <SAMRAI/hier/Box.h>
 
 #include <array>
+#include <cmath>
+#include <cstddef>
 #include <vector>
 
 
@@ -32,6 +34,17 @@ private:
 };
 
 
+
+/** @brief return the table of linear refinement weights of a direction with the given
+ * centering and ratio: element i holds the weights of the left and right coarse nodes for the
+ * fine indexes equal to i modulo the ratio.
+ *
+ * Tables are computed the first time a (centering, ratio) pair is asked for, and are then
+ * shared by all refinement operations.
+ */
+std::vector<std::array<double, 2>> const& linearRefineWeights(QtyCentering centering, int ratio);
+
+
 template<std::size_t dimension>
 class FieldLinearRefineIndexesAndWeights
 {
@@ -46,42 +59,12 @@ public:
                                        SAMRAI::hier::IntVector const& ratio)
         : ratio_{ratio}
     {
-        std::array<bool, dimension> evenRatio;
         std::array<double, dimension> halfRatio;
 
         for (std::size_t iDir = dirX; iDir < dimension; ++iDir)
         {
-            evenRatio[iDir] = ratio(iDir) % 2 == 0;
             halfRatio[iDir] = ratio(iDir) / 2.;
-        }
-
-        // compute weights for each directions
-        // number of points is ratio + 1 if we are primal or odd ratio
-        // and                 ratio otherwise
-        for (std::size_t iDir = dirX; iDir < dimension; ++iDir)
-        {
-            // here we extract the distances of the left index
-            // and then compute the weights : 1.-distance for the left one
-            // and distance for the right index
-            // The number of points depends on the centering, for primal or odd ratio
-            // it is ratio + 1 , for dual with evenRatio it is ratio
-            std::size_t nbrPoints;
-            if (centering[iDir] == QtyCentering::primal || !evenRatio[iDir])
-            {
-                nbrPoints = static_cast<std::size_t>(ratio(iDir)) + 1;
-            }
-            else
-            {
-                nbrPoints = static_cast<std::size_t>(ratio(iDir));
-            }
-
-            UniformIntervalPartitionWeight distances{centering[iDir], ratio(iDir), nbrPoints};
-
-            weights_[iDir].reserve(distances.getUniformDistances().size());
-            for (auto const& distance : distances.getUniformDistances())
-            {
-                weights_[iDir].emplace_back(std::array<double, 2>{{1. - distance, distance}});
-            }
+            weights_[iDir]  = &linearRefineWeights(centering[iDir], ratio(iDir));
         }
 
         // this shift will be use to determine which coarseIndexe we take
@@ -108,20 +91,9 @@ public:
     {
         Point<int, dimension> coarseIndex{fineIndex};
 
-        // here we perform the floating point division, and then we truncate to integer
-        coarseIndex[dirX]
-            = static_cast<int>(static_cast<double>(fineIndex[dirX] + shifts_[dirX]) / ratio_(dirX));
-
-        if constexpr (dimension > 1)
-        {
-            coarseIndex[dirY] = static_cast<int>(
-                static_cast<double>(fineIndex[dirY] + shifts_[dirY]) / ratio_(dirY));
-        }
-
-        if constexpr (dimension > 2)
+        for (std::size_t iDir = dirX; iDir < dimension; ++iDir)
         {
-            coarseIndex[dirZ] = static_cast<int>(
-                static_cast<double>(fineIndex[dirZ] + shifts_[dirZ]) / ratio_(dirZ));
+            coarseIndex[iDir] = computeStartIndex(iDir, fineIndex[iDir]);
         }
 
         return coarseIndex;
@@ -130,9 +102,34 @@ public:
 
 
 
-    std::array<std::vector<std::array<double, 2>>, dimension> const& getWeights() const
+    /** @brief Compute the coarse start index of a fine index along the direction iDir
+     *
+     */
+    int computeStartIndex(std::size_t iDir, int fineIndex) const
+    {
+        // here we perform the floating point division, and then we round down to integer
+        return static_cast<int>(
+            std::floor(static_cast<double>(fineIndex + shifts_[iDir]) / ratio_(iDir)));
+    }
+
+
+
+
+    //! weights of the fine indexes of each direction, see linearRefineWeights()
+    std::array<std::vector<std::array<double, 2>>, dimension> getWeights() const
     {
-        return weights_;
+        std::array<std::vector<std::array<double, 2>>, dimension> weights;
+        for (std::size_t iDir = dirX; iDir < dimension; ++iDir)
+        {
+            weights[iDir] = *weights_[iDir];
+        }
+        return weights;
+    }
+
+
+    std::vector<std::array<double, 2>> const& getWeights(std::size_t iDir) const
+    {
+        return *weights_[iDir];
     }
 
 
@@ -145,24 +142,30 @@ public:
     {
         Point<int, dimension> indexesWeights{fineIndex};
 
-        indexesWeights[dirX] %= ratio_[dirX];
-
-        if constexpr (dimension > 1)
-        {
-            indexesWeights[dirY] %= ratio_[dirY];
-        }
-        if constexpr (dimension > 2)
+        for (std::size_t iDir = dirX; iDir < dimension; ++iDir)
         {
-            indexesWeights[dirZ] %= ratio_[dirZ];
+            indexesWeights[iDir] = computeWeightIndex(iDir, fineIndex[iDir]);
         }
 
         return indexesWeights;
     }
 
+
+
+
+    /** @brief Compute the index of weigths of a fine index along the direction iDir, which is
+     * the fine index modulo the ratio, also for negative indexes
+     */
+    int computeWeightIndex(std::size_t iDir, int fineIndex) const
+    {
+        int const ratio = ratio_(iDir);
+        return ((fineIndex % ratio) + ratio) % ratio;
+    }
+
 private:
     SAMRAI::hier::IntVector const ratio_;
 
-    std::array<std::vector<std::array<double, 2>>, dimension> weights_;
+    std::array<std::vector<std::array<double, 2>> const*, dimension> weights_;
     Point<double, dimension> shifts_;
 };
 
@@ -179,8 +182,11 @@ public:
         : indexesAndWeights_{centering, ratio}
         , fineBox_{destinationGhostBox}
         , coarseBox_{sourceGhostBox}
-        , weights_{indexesAndWeights_.getWeights()}
     {
+        for (std::size_t iDir = dirX; iDir < dimension; ++iDir)
+        {
+            weights_[iDir] = &indexesAndWeights_.getWeights(iDir);
+        }
     }
 
 
@@ -191,7 +197,7 @@ public:
     void operator()(FieldT const& sourceField, FieldT& destinationField,
                     Point<int, dimension> fineIndex)
     {
-        TBOX_ASSERT(sourceField.physicalQuantities() == coarseField.physicalQuantities());
+        TBOX_ASSERT(sourceField.physicalQuantities() == destinationField.physicalQuantities());
 
         // First we get the coarseStartIndex for a given fineIndex
         // then we get the index in weights table for a given fineIndex.
@@ -214,7 +220,7 @@ public:
         {
             auto const& xStartIndex = coarseStartIndex[dirX];
 
-            auto const& xWeights = weights_[dirX][iWeight[dirX]];
+            auto const& xWeights = (*weights_[dirX])[iWeight[dirX]];
 
 
             for (std::size_t iShiftX = 0; iShiftX < xWeights.size(); ++iShiftX)
@@ -232,8 +238,8 @@ public:
             auto const& xStartIndex = coarseStartIndex[dirX];
             auto const& yStartIndex = coarseStartIndex[dirY];
 
-            auto const& xWeights = weights_[dirX][iWeight[dirX]];
-            auto const& yWeights = weights_[dirY][iWeight[dirY]];
+            auto const& xWeights = (*weights_[dirX])[iWeight[dirX]];
+            auto const& yWeights = (*weights_[dirY])[iWeight[dirY]];
 
 
 
@@ -256,9 +262,9 @@ public:
             auto const& yStartIndex = coarseStartIndex[dirY];
             auto const& zStartIndex = coarseStartIndex[dirZ];
 
-            auto const& xWeights = weights_[dirX][iWeight[dirX]];
-            auto const& yWeights = weights_[dirY][iWeight[dirY]];
-            auto const& zWeights = weights_[dirY][iWeight[dirZ]];
+            auto const& xWeights = (*weights_[dirX])[iWeight[dirX]];
+            auto const& yWeights = (*weights_[dirY])[iWeight[dirY]];
+            auto const& zWeights = (*weights_[dirZ])[iWeight[dirZ]];
 
 
             for (std::size_t iShiftX = 0; iShiftX < xWeights.size(); ++iShiftX)
@@ -282,11 +288,160 @@ public:
         }
     }
 
+
+
+
+    /** @brief compute the interpolation from the coarseField(sourceField) to the
+     * fineField(destinationField) at all the fine indexes of fineBox, in AMR indexes.
+     *
+     * The coarse start index and the weights of each fine index only depend on the fine index
+     * along each direction, so they are computed once per direction for the whole box, and the
+     * fine nodes are then filled in the storage order of the destination field.
+     */
+    template<typename FieldT>
+    void operator()(FieldT const& sourceField, FieldT& destinationField,
+                    SAMRAI::hier::Box const& fineBox)
+    {
+        TBOX_ASSERT(sourceField.physicalQuantities() == destinationField.physicalQuantities());
+
+        if (fineBox.empty())
+        {
+            return;
+        }
+
+        std::array<std::vector<FineNodeStencil>, dimension> stencils;
+        for (std::size_t iDir = dirX; iDir < dimension; ++iDir)
+        {
+            stencils[iDir] = stencils_(iDir, fineBox.lower(iDir), fineBox.upper(iDir));
+        }
+
+        auto const xFineStart
+            = static_cast<std::size_t>(fineBox.lower(dirX) - fineBox_.lower(dirX));
+
+        if constexpr (dimension == 1)
+        {
+            for (std::size_t ix = 0; ix < stencils[dirX].size(); ++ix)
+            {
+                auto const& xStencil = stencils[dirX][ix];
+
+                double fieldValue = 0.;
+                for (std::size_t iShiftX = 0; iShiftX < 2; ++iShiftX)
+                {
+                    fieldValue
+                        += sourceField(xStencil.coarseStart + iShiftX) * xStencil.weights[iShiftX];
+                }
+
+                destinationField(xFineStart + ix) = fieldValue;
+            }
+        }
+        else if constexpr (dimension == 2)
+        {
+            auto const yFineStart
+                = static_cast<std::size_t>(fineBox.lower(dirY) - fineBox_.lower(dirY));
+
+            for (std::size_t ix = 0; ix < stencils[dirX].size(); ++ix)
+            {
+                auto const& xStencil = stencils[dirX][ix];
+
+                for (std::size_t iy = 0; iy < stencils[dirY].size(); ++iy)
+                {
+                    auto const& yStencil = stencils[dirY][iy];
+
+                    double fieldValue = 0.;
+                    for (std::size_t iShiftX = 0; iShiftX < 2; ++iShiftX)
+                    {
+                        double Yinterp = 0.;
+                        for (std::size_t iShiftY = 0; iShiftY < 2; ++iShiftY)
+                        {
+                            Yinterp += sourceField(xStencil.coarseStart + iShiftX,
+                                                   yStencil.coarseStart + iShiftY)
+                                       * yStencil.weights[iShiftY];
+                        }
+                        fieldValue += Yinterp * xStencil.weights[iShiftX];
+                    }
+
+                    destinationField(xFineStart + ix, yFineStart + iy) = fieldValue;
+                }
+            }
+        }
+        else if constexpr (dimension == 3)
+        {
+            auto const yFineStart
+                = static_cast<std::size_t>(fineBox.lower(dirY) - fineBox_.lower(dirY));
+            auto const zFineStart
+                = static_cast<std::size_t>(fineBox.lower(dirZ) - fineBox_.lower(dirZ));
+
+            for (std::size_t ix = 0; ix < stencils[dirX].size(); ++ix)
+            {
+                auto const& xStencil = stencils[dirX][ix];
+
+                for (std::size_t iy = 0; iy < stencils[dirY].size(); ++iy)
+                {
+                    auto const& yStencil = stencils[dirY][iy];
+
+                    for (std::size_t iz = 0; iz < stencils[dirZ].size(); ++iz)
+                    {
+                        auto const& zStencil = stencils[dirZ][iz];
+
+                        double fieldValue = 0.;
+                        for (std::size_t iShiftX = 0; iShiftX < 2; ++iShiftX)
+                        {
+                            double Yinterp = 0.;
+                            for (std::size_t iShiftY = 0; iShiftY < 2; ++iShiftY)
+                            {
+                                double Zinterp = 0.;
+                                for (std::size_t iShiftZ = 0; iShiftZ < 2; ++iShiftZ)
+                                {
+                                    Zinterp += sourceField(xStencil.coarseStart + iShiftX,
+                                                           yStencil.coarseStart + iShiftY,
+                                                           zStencil.coarseStart + iShiftZ)
+                                               * zStencil.weights[iShiftZ];
+                                }
+                                Yinterp += Zinterp * yStencil.weights[iShiftY];
+                            }
+                            fieldValue += Yinterp * xStencil.weights[iShiftX];
+                        }
+
+                        destinationField(xFineStart + ix, yFineStart + iy, zFineStart + iz)
+                            = fieldValue;
+                    }
+                }
+            }
+        }
+    }
+
 private:
     FieldLinearRefineIndexesAndWeights<dimension> const indexesAndWeights_;
     SAMRAI::hier::Box const fineBox_;
     SAMRAI::hier::Box const coarseBox_;
-    std::array<std::vector<std::array<double, 2>>, dimension> const& weights_;
+    std::array<std::vector<std::array<double, 2>> const*, dimension> weights_;
+
+
+    //! local coarse start index and weights of a fine index along one direction
+    struct FineNodeStencil
+    {
+        std::size_t coarseStart;
+        std::array<double, 2> weights;
+    };
+
+
+    //! stencils of the fine indexes from lower to upper, in AMR indexes, along direction iDir
+    std::vector<FineNodeStencil> stencils_(std::size_t iDir, int lower, int upper) const
+    {
+        std::vector<FineNodeStencil> stencils;
+        stencils.reserve(static_cast<std::size_t>(upper - lower + 1));
+
+        for (int fineIndex = lower; fineIndex <= upper; ++fineIndex)
+        {
+            auto const coarseStart = indexesAndWeights_.computeStartIndex(iDir, fineIndex);
+            auto const iWeight     = indexesAndWeights_.computeWeightIndex(iDir, fineIndex);
+
+            stencils.push_back(
+                {static_cast<std::size_t>(coarseStart - coarseBox_.lower(iDir)),
+                 (*weights_[iDir])[static_cast<std::size_t>(iWeight)]});
+        }
+        return stencils;
+    }
 };
 
 
@@ -1,20 +1,26 @@
 #ifndef PHARE_SRC_AMR_DATA_PARTICLES_PARTICLES_DATA_H
 #define PHARE_SRC_AMR_DATA_PARTICLES_PARTICLES_DATA_H
 
+#include <algorithm>
 #include <numeric>
 #include <stdexcept>
+#include <vector>
 
 #include <SAMRAI/hier/BoxOverlap.h>
 #include <SAMRAI/hier/IntVector.h>
 #include <SAMRAI/hier/PatchData.h>
 #include <SAMRAI/pdat/CellOverlap.h>
-#include <SAMRAI/tbox/MemoryUtilities.h>
+#include <SAMRAI/tbox/MessageStream.h>
 
 
 #include "data/ions/ion_population/particle_pack.h"
+#include "data/particles/outgoing_particles.h"
+#include "data/particles/packed_particle.h"
 #include "data/particles/particle.h"
 #include "data/particles/particle_array.h"
+#include "data/particles/particle_cell_index.h"
 #include "tools/amr_utils.h"
+#include "utilities/box/box.h"
 
 namespace PHARE
 {
@@ -40,8 +46,23 @@ namespace PHARE
  * that also are level boundaries. These particles are getting here when there is a particle
  * refinement from a coarser level
  *
+ * The particle arrays are of type ParticleArrayT, which defaults to ParticleArray<dim>. Any
+ * container with the same interface, like ParticleArraySoA<dim>, can be used instead.
+ *
+ * Optionally, domain and ghost particles can be sorted by cell with sortByCell(). Copies,
+ * packing and counting then only visit the particles of the cells they select instead of
+ * scanning all of them for each overlap box.
+ *
+ * The particles an overlap selects for streaming are computed by getDataStreamSize() and
+ * kept until packStream() packs them, so that sizing and packing the stream of an exchange
+ * do not select them twice. Each exchange selects them again, so that particles moved in
+ * place between two exchanges are not streamed from stale indexes.
+ *
+ * The particles the pusher put in a bucket of OutgoingParticles can also be streamed with
+ * packBucketStream(), which does not select them again.
+ *
  */
-template<std::size_t dim>
+template<std::size_t dim, typename ParticleArrayT = ParticleArray<dim>>
 class ParticlesData : public SAMRAI::hier::PatchData
 {
 public:
@@ -96,6 +117,7 @@ public:
             if (!intersectionBox.empty())
             {
                 copy_(sourceGhostBox, myGhostBox, intersectionBox, *pSource);
+                particlesChanged_();
             }
         }
         else
@@ -174,7 +196,9 @@ public:
                     }
 
                 } // end loop over boxes
-            }     // end no rotate
+
+                particlesChanged_();
+            } // end no rotate
             else
             {
                 throw std::runtime_error("copy with rotate not implemented");
@@ -203,14 +227,22 @@ public:
 
 
 
+    /**
+     * @brief getDataStreamSize returns the exact number of bytes packStream() writes for this
+     * overlap: the number of particles followed by the particles in PackedParticle format.
+     */
     virtual size_t getDataStreamSize(SAMRAI::hier::BoxOverlap const& overlap) const final
     {
         SAMRAI::pdat::CellOverlap const* pOverlap{
             dynamic_cast<SAMRAI::pdat::CellOverlap const*>(&overlap)};
 
-        std::size_t numberParticles = countNumberParticlesIn_(*pOverlap);
+        auto selection              = selectParticles_(*pOverlap);
+        std::size_t numberParticles = selection.domain.size() + selection.ghost.size();
+
+        keepSelection_(std::move(selection));
 
-        return SAMRAI::tbox::MemoryUtilities::align(numberParticles * sizeof(ParticleArray<dim>));
+        return SAMRAI::tbox::MessageStream::getSizeof<std::size_t>(1)
+               + SAMRAI::tbox::MessageStream::getSizeof<PackedParticle<dim>>(numberParticles);
     }
 
 
@@ -253,6 +285,11 @@ public:
      * at this point with iCell=1 we know the particle should be placed into the interior particle
      * buffer
      *
+     * Particles are streamed in the PackedParticle format, after their number, which is
+     * written even if the overlap is empty.
+     *
+     * The particles selected by the getDataStreamSize() call of the same exchange are packed
+     * and then dropped. Without such a call, they are selected here.
      */
     virtual void packStream(SAMRAI::tbox::MessageStream& stream,
                             SAMRAI::hier::BoxOverlap const& overlap) const final
@@ -262,39 +299,85 @@ public:
 
         TBOX_ASSERT(pOverlap != nullptr);
 
-        std::vector<Particle<dim>> specie;
+        auto const selection = takeSelection_(*pOverlap);
+
+        std::vector<PackedParticle<dim>> specie;
+        specie.reserve(selection.domain.size() + selection.ghost.size());
 
-        if (pOverlap->isOverlapEmpty())
+        auto particleShift = localToShiftedAMR(getGhostBox(), pOverlap->getTransformation());
+
+        auto packParticle = [&](auto const& particle) {
+            Particle<dim> shiftedParticle = particle;
+            shiftParticle_(particleShift, shiftedParticle);
+            specie.push_back(toPackedParticle(shiftedParticle));
+        };
+
+        for (auto iPart : selection.domain)
         {
-            constexpr std::size_t zero = 0;
-            stream << zero;
+            packParticle(domainParticles[iPart]);
         }
-        else
+        for (auto iPart : selection.ghost)
         {
-            SAMRAI::hier::Transformation const& transformation = pOverlap->getTransformation();
-            if (transformation.getRotation() == SAMRAI::hier::Transformation::NO_ROTATE)
-            {
-                SAMRAI::hier::BoxContainer const& boxContainer
-                    = pOverlap->getDestinationBoxContainer();
-                for (auto const& destinationBox : boxContainer)
-                {
-                    auto const& sourceBox = getGhostBox();
+            packParticle(ghostParticles[iPart]);
+        }
 
-                    SAMRAI::hier::Box transformedSource{sourceBox};
-                    transformation.transform(transformedSource);
+        stream << specie.size();
+        stream.pack(specie.data(), specie.size());
+    }
 
-                    SAMRAI::hier::Box intersectionBox{transformedSource * destinationBox};
 
-                    pack_(specie, intersectionBox, sourceBox, transformation);
-                }
-            }
-            else
-            {
-                throw std::runtime_error("Error - rotations not handled in PHARE");
-            }
-            stream << specie.size();
-            stream.pack(specie.data(), specie.size());
+
+
+    /**
+     * @brief getBucketStreamSize returns the exact number of bytes packBucketStream() writes for
+     * the given bucket of OutgoingParticles.
+     */
+    std::size_t
+    getBucketStreamSize(typename OutgoingParticles<dim>::bucket_type const& bucket) const
+    {
+        return SAMRAI::tbox::MessageStream::getSizeof<std::size_t>(1)
+               + SAMRAI::tbox::MessageStream::getSizeof<PackedParticle<dim>>(bucket.size());
+    }
+
+
+
+
+    /**
+     * @brief packBucketStream packs a bucket of the OutgoingParticles of this patch in the
+     * format packStream() writes, so that unpackStream() reads it with the overlap of the
+     * neighbor patch of the bucket direction.
+     *
+     * Bucket particles already are in PackedParticle format, with their cell in AMR index
+     * space, so they are neither selected nor converted: the bucket is streamed as it is, and
+     * only copied to be shifted when the transformation has an offset, i.e. across a periodic
+     * boundary. The destination keeps the particles that are in its overlap boxes.
+     */
+    void packBucketStream(SAMRAI::tbox::MessageStream& stream,
+                          typename OutgoingParticles<dim>::bucket_type const& bucket,
+                          SAMRAI::hier::Transformation const& transformation) const
+    {
+        auto const& offset = transformation.getOffset();
+
+        bool isShifted = false;
+        for (auto iDim = 0u; iDim < dim; ++iDim)
+        {
+            isShifted = isShifted || offset[iDim] != 0;
         }
+
+        stream << bucket.size();
+
+        if (!isShifted)
+        {
+            stream.pack(bucket.data(), bucket.size());
+            return;
+        }
+
+        auto shifted = bucket;
+        for (auto& particle : shifted)
+        {
+            shiftParticle_(offset, particle);
+        }
+        stream.pack(shifted.data(), shifted.size());
     }
 
 
@@ -319,93 +402,243 @@ public:
             = dynamic_cast<SAMRAI::pdat::CellOverlap const*>(&overlap);
         TBOX_ASSERT(pOverlap != nullptr);
 
-        std::vector<Particle<dim>> particleArray;
+        // unpack particles into a particle array
+        size_t numberParticles = 0;
+        stream >> numberParticles;
+
+        std::vector<PackedParticle<dim>> particleArray(numberParticles);
+        stream.unpack(particleArray.data(), numberParticles);
 
         if (!pOverlap->isOverlapEmpty())
         {
-            // unpack particles into a particle array
-            size_t numberParticles = 0;
-            stream >> numberParticles;
-            particleArray.resize(numberParticles);
-            stream.unpack(particleArray.data(), numberParticles);
-
             // ok now our goal is to put the particles we have just unpacked
             // into the particleData and in the proper particleArray : interior or ghost
 
             SAMRAI::hier::Transformation const& transformation = pOverlap->getTransformation();
             if (transformation.getRotation() == SAMRAI::hier::Transformation::NO_ROTATE)
             {
-                // we loop over all boxes in the overlap
-                // we have to first take the intersection of each of these boxes
-                // with our ghostBox. This is where unpacked particles should go.
-
-                SAMRAI::hier::BoxContainer const& destinationBoxes
-                    = pOverlap->getDestinationBoxContainer();
+                // unpacked particles have their iCell in our AMR index space. Each of them is
+                // shifted once to local index space, and then compared to the intersections of
+                // the overlap boxes with our ghostBox, also in local index space. Particles in
+                // one of these boxes go to the interior or ghost array depending on whether
+                // they are in interiorLocalBox_, the others are discarded.
 
+                auto const& ghostBox = getGhostBox();
+                auto particleShift   = AMRToLocal(ghostBox);
 
-                for (auto const& box : destinationBoxes)
+                std::vector<SAMRAI::hier::Box> localIntersects;
+                for (auto const& box : pOverlap->getDestinationBoxContainer())
                 {
-                    // our goal here is :
-                    // 1/ to check if the each particle is in the intersect of the overlap boxes and
-                    // our ghostBox 2/ if yes, check if these particles should go within the
-                    // interior array or ghost array
-
-                    // first we need to calculate the intersect between our ghostBox and the
-                    // overlapBox these and the resulting intersect are in AMR index space unpacked
-                    // particles have their iCell in our AMR index space. we could :
-                    //  1- compare their iCell with the intersect right away, if within shit them to
-                    //  local indexing and push them in proper array
-                    // or
-                    // 2- translate the intersect from  AMR to local indexing, shift the particles
-                    // from AMR to local, and do the comparison in local index space and then push
-                    // them in the proper array
-
-                    auto const intersect = getGhostBox() * box;
-
-
-                    // we chose first option, so get the intersect in local index space
-                    // and get the vector to shift a particle from our AMR space to local index
-                    // space
-                    auto intersectLocalSource = AMRToLocal(intersect, getGhostBox());
-                    auto particleShift        = AMRToLocal(getGhostBox());
-
-                    for (auto const& particle : particleArray)
+                    auto const intersect = ghostBox * box;
+                    if (!intersect.empty())
                     {
-                        // shift the particle to local index space
-                        // and if it is in intersection, decide in which array to push it.
-                        auto shiftedParticle{particle};
-                        shiftParticle_(particleShift, shiftedParticle);
+                        localIntersects.push_back(AMRToLocal(intersect, ghostBox));
+                    }
+                }
+
+                auto isInIntersects = [&](auto const& particle) {
+                    return std::any_of(
+                        std::begin(localIntersects), std::end(localIntersects),
+                        [&](auto const& localBox) { return isInBox_(localBox, particle); });
+                };
+
+
+                // first classify the particles, so that arrays grow once
+                std::vector<UnpackDestination> destinations(numberParticles,
+                                                            UnpackDestination::discard);
+                std::size_t nbrDomainParticles = 0;
+                std::size_t nbrGhostParticles  = 0;
 
-                        if (isInBox_(intersectLocalSource, shiftedParticle))
+                for (std::size_t iPart = 0; iPart < numberParticles; ++iPart)
+                {
+                    auto& particle = particleArray[iPart];
+                    shiftParticle_(particleShift, particle);
+
+                    if (isInIntersects(particle))
+                    {
+                        if (isInBox_(interiorLocalBox_, particle))
                         {
-                            if (isInBox_(interiorLocalBox_, shiftedParticle))
-                            {
-                                domainParticles.push_back(std::move(shiftedParticle));
-                            }
-                            else
-                            {
-                                ghostParticles.push_back(std::move(shiftedParticle));
-                            }
+                            destinations[iPart] = UnpackDestination::domain;
+                            ++nbrDomainParticles;
+                        }
+                        else
+                        {
+                            destinations[iPart] = UnpackDestination::ghost;
+                            ++nbrGhostParticles;
                         }
-                    } // end species loop
-                }     // end box loop
-            }         // end no rotation
-        }             // end overlap not empty
+                    }
+                }
+
+
+                // then append them to their array
+                reserveMore_(domainParticles, nbrDomainParticles);
+                reserveMore_(ghostParticles, nbrGhostParticles);
+
+                for (std::size_t iPart = 0; iPart < numberParticles; ++iPart)
+                {
+                    if (destinations[iPart] == UnpackDestination::domain)
+                    {
+                        domainParticles.push_back(fromPackedParticle(particleArray[iPart]));
+                    }
+                    else if (destinations[iPart] == UnpackDestination::ghost)
+                    {
+                        ghostParticles.push_back(fromPackedParticle(particleArray[iPart]));
+                    }
+                }
+
+                particlesChanged_();
+            } // end no rotation
+        }     // end overlap not empty
+    }
+
+
+
+    /**
+     * @brief getPointer gives the core access to the particle arrays. Since the core is then
+     * free to move particles, this drops the cell offset tables built by sortByCell()
+     */
+    ParticlesPack<ParticleArrayT>* getPointer()
+    {
+        particlesChanged_();
+        return &pack;
+    }
+
+
+
+
+    /**
+     * @brief sortByCell sorts the domain and ghost particles by cell and builds, for each
+     * array, the table of offsets of the first particle of each cell of the ghost box.
+     *
+     * copy, packStream and getDataStreamSize then select the particles of a box by jumping
+     * to the ranges of its cells. The tables remain in use until particles are copied or
+     * unpacked into this data, or until getPointer() is called. Code modifying the public
+     * particle arrays directly must call sortByCell() again before the next exchange.
+     *
+     * Sorting moves particles, so this also drops the particles selected for overlaps.
+     */
+    void sortByCell()
+    {
+        selections_.clear();
+
+        auto const& ghostBox = getGhostBox();
+
+        Box<int, dim> localGhostBox;
+        for (auto iDim = 0u; iDim < dim; ++iDim)
+        {
+            localGhostBox.upper[iDim] = ghostBox.upper()(iDim) - ghostBox.lower()(iDim);
+        }
+
+        domainIndex_ = CellIndex<dim>{localGhostBox};
+        ghostIndex_  = CellIndex<dim>{localGhostBox};
+        domainIndex_.sort(domainParticles);
+        ghostIndex_.sort(ghostParticles);
+
+        sortedByCell_ = true;
+    }
+
+
+
+
+    //! true if the particles are sorted by cell and the cell offset tables are in use
+    bool isSortedByCell() const
+    {
+        return sortedByCell_ && domainIndex_.size() == domainParticles.size()
+               && ghostIndex_.size() == ghostParticles.size();
     }
 
 
 
-    ParticlesPack<ParticleArray<dim>>* getPointer() { return &pack; }
+    /**
+     * @brief transfer moves into our domain particles the domain particles of the source that
+     * are, once shifted by the overlap transformation, in our domain cells within the overlap
+     * boxes. It is meant for regridding, where the source is discarded right after and our
+     * ghost particles are filled afterwards from the new level.
+     *
+     * Since a domain cell belongs to one patch of a level, these particles are not needed by
+     * any other destination, so they are taken out of the source arrays instead of being
+     * copied. If they are all the source has and we have no domain particles yet, the whole
+     * array is handed over. In any case, their iCell is shifted in place in our array.
+     */
+    void transfer(ParticlesData& source, SAMRAI::hier::BoxOverlap const& overlap)
+    {
+        SAMRAI::pdat::CellOverlap const* pOverlap{
+            dynamic_cast<SAMRAI::pdat::CellOverlap const*>(&overlap)};
+
+        TBOX_ASSERT(pOverlap != nullptr);
+
+        SAMRAI::hier::Transformation const& transformation = pOverlap->getTransformation();
+        if (transformation.getRotation() != SAMRAI::hier::Transformation::NO_ROTATE)
+        {
+            throw std::runtime_error("transfer with rotate not implemented");
+        }
+        if (!isSameBlock(transformation))
+        {
+            throw std::runtime_error("Error - multiblock hierarchies not handled");
+        }
+
+        auto const& sourceGhostBox = source.getGhostBox();
+
+        SAMRAI::hier::Box shiftedSourceBox{sourceGhostBox};
+        transformation.transform(shiftedSourceBox);
+
+        // indexes of the source domain particles landing in our domain, for all boxes
+        std::vector<std::size_t> selected;
+        for (auto const& overlapBox : pOverlap->getDestinationBoxContainer())
+        {
+            SAMRAI::hier::Box intersectionBox{overlapBox * shiftedSourceBox * getBox()};
+
+            if (!intersectionBox.empty())
+            {
+                auto const localSourceSelectionBox
+                    = localSelectionBox_(intersectionBox, sourceGhostBox, transformation);
+
+                source.forEachParticleIndexIn_(
+                    localSourceSelectionBox, source.domainParticles, source.domainIndex_,
+                    [&selected](std::size_t iPart) { selected.push_back(iPart); });
+            }
+        }
+
+        auto& sourceParticles = source.domainParticles;
+        auto const firstNew   = domainParticles.size();
+
+        if (domainParticles.empty() && selected.size() == sourceParticles.size())
+        {
+            domainParticles = std::move(sourceParticles);
+            sourceParticles.clear();
+        }
+        else
+        {
+            reserveMore_(domainParticles, selected.size());
+            for (auto iPart : selected)
+            {
+                domainParticles.push_back(std::move(sourceParticles[iPart]));
+            }
+            removeParticles_(sourceParticles, selected);
+        }
+
+        auto const particleShift
+            = particleCellShift_(sourceGhostBox, transformation, getGhostBox());
+
+        for (auto iPart = firstNew; iPart < domainParticles.size(); ++iPart)
+        {
+            auto&& particle = domainParticles[iPart];
+            shiftParticle_(particleShift, particle);
+        }
+
+        particlesChanged_();
+        source.particlesChanged_();
+    }
 
 
 
     // Core interface
     // these particles arrays are public because core module is free to use
     // them easily
-    ParticleArray<dim> domainParticles;
-    ParticleArray<dim> ghostParticles;
-    ParticleArray<dim> coarseToFineParticles;
-    ParticlesPack<ParticleArray<dim>> pack;
+    ParticleArrayT domainParticles;
+    ParticleArrayT ghostParticles;
+    ParticleArrayT coarseToFineParticles;
+    ParticlesPack<ParticleArrayT> pack;
 
 
 
@@ -415,6 +648,81 @@ private:
     //! index"
     SAMRAI::hier::Box interiorLocalBox_;
 
+    //! cell offset tables of the domain and ghost particles, see sortByCell()
+    CellIndex<dim> domainIndex_;
+    CellIndex<dim> ghostIndex_;
+    bool sortedByCell_{false};
+
+
+    /** OverlapSelection holds the indexes of the domain and ghost particles an overlap selects
+     * for streaming. It is identified by the destination boxes and offset of the overlap, and
+     * by the number of particles in our arrays when it was computed.
+     */
+    struct OverlapSelection
+    {
+        std::vector<SAMRAI::hier::Box> destinationBoxes;
+        SAMRAI::hier::IntVector offset;
+        std::size_t nbrDomainParticles;
+        std::size_t nbrGhostParticles;
+        std::vector<std::size_t> domain;
+        std::vector<std::size_t> ghost;
+    };
+
+    //! selections computed by getDataStreamSize() and not packed yet, see keepSelection_()
+    mutable std::vector<OverlapSelection> selections_;
+
+
+
+    //! array in which unpackStream() puts a received particle
+    enum class UnpackDestination { discard, domain, ghost };
+
+
+
+    //! make room for n more particles, growing the capacity geometrically as push_back() does
+    static void reserveMore_(ParticleArrayT& particles, std::size_t n)
+    {
+        auto const size = particles.size() + n;
+        if (size > particles.capacity())
+        {
+            particles.reserve(std::max(size, 2 * particles.capacity()));
+        }
+    }
+
+
+
+    //! remove the particles of the given indexes, keeping the order of the others
+    static void removeParticles_(ParticleArrayT& particles, std::vector<std::size_t> const& indexes)
+    {
+        std::vector<bool> removed(particles.size(), false);
+        for (auto iPart : indexes)
+        {
+            removed[iPart] = true;
+        }
+
+        std::size_t nbrKept = 0;
+        for (std::size_t iPart = 0; iPart < particles.size(); ++iPart)
+        {
+            if (!removed[iPart])
+            {
+                if (nbrKept != iPart)
+                {
+                    particles[nbrKept] = particles[iPart];
+                }
+                ++nbrKept;
+            }
+        }
+        particles.resize(nbrKept);
+    }
+
+
+
+    //! to be called when particles are added, removed or moved in our arrays
+    void particlesChanged_()
+    {
+        sortedByCell_ = false;
+        selections_.clear();
+    }
+
 
 
 
@@ -495,244 +803,289 @@ private:
                SAMRAI::hier::IntVector const& shiftParticleCellToDest,
                SAMRAI::hier::Box const& localSourceSelectionBox)
     {
-        std::array<decltype(sourceData.domainParticles) const*, 2> particlesArrays{
-            &sourceData.domainParticles, &sourceData.ghostParticles};
-
-        // loop over both interior and ghost source particle buffers
-        // for each of their particles, check they should be copied (they should be intersection)
-        // and if they do, check into which of our particle buffers it should be copied into.
+        // for both interior and ghost source particle buffers, take the particles
+        // that should be copied (they should be in the intersection)
+        // and check into which of our particle buffers they should be copied into.
         // beware the before checking wether it is inside our domain or not, we must
         // translate their iCell from local source indexing to our local indexing.
-        for (auto const& sourceParticlesArray : particlesArrays)
-        {
-            for (auto const& particle : *sourceParticlesArray)
-            {
-                if (isInBox_(localSourceSelectionBox, particle))
-                {
-                    auto shiftedParticle{particle};
+        auto copyParticle = [&](auto const& particle) {
+            Particle<dim> shiftedParticle = particle;
 
-                    shiftParticle_(shiftParticleCellToDest, shiftedParticle);
+            shiftParticle_(shiftParticleCellToDest, shiftedParticle);
 
-                    // TODO isInBox existe déja on peut pas l'utiliser ?
-                    if (isInBox_(interiorLocalBox_, shiftedParticle))
-                    {
-                        // shiftParticle_(ghostWidth, shiftedParticle);
-                        domainParticles.push_back(std::move(shiftedParticle));
-                    }
-                    else
-                    {
-                        // shiftParticle_(ghostWidth, shiftedParticle);
-                        ghostParticles.push_back(std::move(shiftedParticle));
-                    }
-                }
+            if (isInBox_(interiorLocalBox_, shiftedParticle))
+            {
+                domainParticles.push_back(std::move(shiftedParticle));
             }
-        }
-    }
-
-
+            else
+            {
+                ghostParticles.push_back(std::move(shiftedParticle));
+            }
+        };
 
+        sourceData.forEachParticleIn_(localSourceSelectionBox, sourceData.domainParticles,
+                                      sourceData.domainIndex_, copyParticle);
+        sourceData.forEachParticleIn_(localSourceSelectionBox, sourceData.ghostParticles,
+                                      sourceData.ghostIndex_, copyParticle);
+    }
 
-    bool isInBox_(SAMRAI::hier::Box const& box, Particle<dim> const& particle) const;
 
 
 
+    /**
+     * @brief forEachParticleIn_ calls fn on each particle of the array that is in the given box,
+     * in local index space. If the particles are sorted by cell, only the particles of the
+     * cells of the box are visited, otherwise all of them are tested.
+     */
+    template<typename Fn>
+    void forEachParticleIn_(SAMRAI::hier::Box const& localBox, ParticleArrayT const& particles,
+                            CellIndex<dim> const& index, Fn&& fn) const
+    {
+        forEachParticleIndexIn_(localBox, particles, index,
+                                [&](std::size_t iPart) { fn(particles[iPart]); });
+    }
 
-    void shiftParticle_(SAMRAI::hier::IntVector const& shift, Particle<dim>& particle) const;
 
 
 
-    /**
-     * @brief countNumberParticlesIn_ counts the number of interior particles that lie
-     * within the boxes of an overlap
-     */
-    std::size_t countNumberParticlesIn_(SAMRAI::pdat::CellOverlap const& overlap) const
+    //! same as forEachParticleIn_ but fn is given the index of the particle in the array
+    template<typename Fn>
+    void forEachParticleIndexIn_(SAMRAI::hier::Box const& localBox,
+                                 ParticleArrayT const& particles, CellIndex<dim> const& index,
+                                 Fn&& fn) const
     {
-        std::size_t numberParticles = 0;
-
-        if (overlap.isOverlapEmpty())
+        if (isSortedByCell())
+        {
+            index.forEachRangeIn(toCellIndexBox_(localBox),
+                                 [&](std::size_t first, std::size_t last) {
+                                     for (auto iPart = first; iPart < last; ++iPart)
+                                     {
+                                         fn(iPart);
+                                     }
+                                 });
+
+            auto const outside = index.outsideRange();
+            for (auto iPart = outside.first; iPart < outside.second; ++iPart)
+            {
+                if (isInBox_(localBox, particles[iPart]))
+                {
+                    fn(iPart);
+                }
+            }
+        }
+        else
         {
-            return numberParticles;
+            for (std::size_t iPart = 0; iPart < particles.size(); ++iPart)
+            {
+                if (isInBox_(localBox, particles[iPart]))
+                {
+                    fn(iPart);
+                }
+            }
         }
+    }
 
-        auto const& boxes = overlap.getDestinationBoxContainer();
 
-        for (auto const& box : boxes)
-        {
-            SAMRAI::hier::Box shiftedBox{box};
-            SAMRAI::hier::Transformation const& transformation = overlap.getTransformation();
-            transformation.transform(shiftedBox);
-            SAMRAI::hier::Box intersectionBox{shiftedBox * getBox()};
 
-            numberParticles += countNumberParticlesIn_(intersectionBox);
+
+    Box<int, dim> toCellIndexBox_(SAMRAI::hier::Box const& box) const
+    {
+        Box<int, dim> cellIndexBox;
+        for (auto iDim = 0u; iDim < dim; ++iDim)
+        {
+            cellIndexBox.lower[iDim] = box.lower()(iDim);
+            cellIndexBox.upper[iDim] = box.upper()(iDim);
         }
-        return numberParticles;
+        return cellIndexBox;
     }
 
 
-    /**
-     * @brief countNumberParticlesIn_ returns the number of interior particles within a given box
-     *
-     * the box given is in AMR index space so the function first needs to put it in
-     * local indexing relative to the domain box
-     */
-    std::size_t countNumberParticlesIn_(SAMRAI::hier::Box const& box) const
+
+
+    template<typename ParticleT>
+    bool isInBox_(SAMRAI::hier::Box const& box, ParticleT const& particle) const
     {
-        std::size_t numberParticles{0};
+        auto const& iCell = particle.iCell;
 
-        auto localSourceBox = AMRToLocal(box, getBox());
+        auto const& lower = box.lower();
+        auto const& upper = box.upper();
 
-        for (auto const& particle : domainParticles)
+        for (auto iDim = 0u; iDim < dim; ++iDim)
         {
-            if (isInBox_(localSourceBox, particle))
+            if (iCell[iDim] < lower(iDim) || iCell[iDim] > upper(iDim))
             {
-                ++numberParticles;
+                return false;
             }
         }
-        return numberParticles;
+        return true;
     }
 
 
+
+
+    template<typename ParticleT>
+    void shiftParticle_(SAMRAI::hier::IntVector const& shift, ParticleT& particle) const
+    {
+        for (auto iDim = 0u; iDim < dim; ++iDim)
+        {
+            particle.iCell[iDim] += shift[iDim];
+        }
+    }
+
+
+
     /**
-     * @brief localToShiftedAMR returns the vector to shift a particle cell from a local
-     * index to an AMR offseted index. This function is to be used to shift particles cells
-     * before packing them to the stream.
-     * At the unpack stage, when the destination box is known, one will have to
-     * call AMRToLocal() to finish the index shift to get particles cells into destination local
-     * index space
+     * @brief selectParticles_ returns the domain and ghost particles packStream() streams for
+     * an overlap, i.e. those whose cell, shifted by the overlap transformation, is in one of
+     * the destination boxes.
      */
-    SAMRAI::hier::IntVector
-    localToShiftedAMR(SAMRAI::hier::Box const& sourceGhostBox,
-                      SAMRAI::hier::Transformation const& transformation) const
+    OverlapSelection selectParticles_(SAMRAI::pdat::CellOverlap const& overlap) const
     {
-        SAMRAI::hier::IntVector shift{sourceGhostBox.lower()}; // move to AMR space
-        shift += transformation.getOffset(); // translate AMR indexes with the transfo offset
-        return shift;
+        SAMRAI::hier::Transformation const& transformation = overlap.getTransformation();
+        if (transformation.getRotation() != SAMRAI::hier::Transformation::NO_ROTATE)
+        {
+            throw std::runtime_error("Error - rotations not handled in PHARE");
+        }
+
+        OverlapSelection selection{destinationBoxes_(overlap),
+                                   transformation.getOffset(),
+                                   domainParticles.size(),
+                                   ghostParticles.size(),
+                                   {},
+                                   {}};
+
+        auto const& sourceBox = getGhostBox();
+
+        SAMRAI::hier::Box transformedSource{sourceBox};
+        transformation.transform(transformedSource);
+
+        // only the interior and ghost particles are to be streamed
+        // coarseToFine particles should not be.
+        for (auto const& destinationBox : selection.destinationBoxes)
+        {
+            SAMRAI::hier::Box intersectionBox{transformedSource * destinationBox};
+
+            auto const localSelectionSourceBox
+                = localSelectionBox_(intersectionBox, sourceBox, transformation);
+
+            forEachParticleIndexIn_(localSelectionSourceBox, domainParticles, domainIndex_,
+                                    [&](std::size_t iPart) { selection.domain.push_back(iPart); });
+            forEachParticleIndexIn_(localSelectionSourceBox, ghostParticles, ghostIndex_,
+                                    [&](std::size_t iPart) { selection.ghost.push_back(iPart); });
+        }
+
+        return selection;
     }
 
 
 
 
-    void pack_(std::vector<Particle<dim>>& buffer, SAMRAI::hier::Box const& intersectionBox,
-               SAMRAI::hier::Box const& sourceBox,
-               SAMRAI::hier::Transformation const& transformation) const
+    //! keep a selection until packStream() is called for its overlap, replacing an older one
+    void keepSelection_(OverlapSelection&& selection) const
     {
-        auto particleShift = localToShiftedAMR(sourceBox, transformation);
+        auto kept = findSelection_(selection.destinationBoxes, selection.offset);
+        if (kept != std::end(selections_))
+        {
+            *kept = std::move(selection);
+        }
+        else
+        {
+            selections_.push_back(std::move(selection));
+        }
+    }
 
 
-        // take the intersectionBox, which is in AMR space aligned with the destination
-        // shift its AMR index to the source location
-        // and move the shifted AMR index to local index space
-        auto localSelectionSourceBox{intersectionBox};
-        transformation.inverseTransform(localSelectionSourceBox);
-        AMRToLocal(localSelectionSourceBox, sourceBox);
 
-        // now it is possible to compare localSelectionSourceBox indexing and
-        // particle.iCell on source patch data to select those in the intersection.
 
-        // only the interior and ghost particles are to be copied
-        // coarseToFine particles should not be copied.
-        std::array<decltype(domainParticles) const*, 2> particlesArrays{&domainParticles,
-                                                                        &ghostParticles};
+    /**
+     * @brief takeSelection_ removes and returns the selection kept for the overlap, if it was
+     * computed with the current number of particles, or selects the particles otherwise
+     */
+    OverlapSelection takeSelection_(SAMRAI::pdat::CellOverlap const& overlap) const
+    {
+        auto kept = findSelection_(destinationBoxes_(overlap),
+                                   overlap.getTransformation().getOffset());
 
-        for (auto const& sourceParticlesArray : particlesArrays)
+        if (kept == std::end(selections_))
         {
-            for (auto const& particle : *sourceParticlesArray)
-            {
-                if (isInBox_(localSelectionSourceBox, particle))
-                {
-                    auto shiftedParticle{particle};
-                    shiftParticle_(particleShift, shiftedParticle);
-                    buffer.push_back(shiftedParticle);
-                }
-            }
+            return selectParticles_(overlap);
         }
+
+        auto selection = std::move(*kept);
+        selections_.erase(kept);
+
+        if (selection.nbrDomainParticles != domainParticles.size()
+            || selection.nbrGhostParticles != ghostParticles.size())
+        {
+            return selectParticles_(overlap);
+        }
+        return selection;
     }
-};
 
 
 
 
-template<>
-inline bool ParticlesData<1>::isInBox_(SAMRAI::hier::Box const& box,
-                                       Particle<1> const& particle) const
-{
-    auto const& iCell = particle.iCell;
+    auto findSelection_(std::vector<SAMRAI::hier::Box> const& destinationBoxes,
+                        SAMRAI::hier::IntVector const& offset) const
+    {
+        return std::find_if(std::begin(selections_), std::end(selections_),
+                            [&](OverlapSelection const& selection) {
+                                return selection.offset == offset
+                                       && selection.destinationBoxes == destinationBoxes;
+                            });
+    }
 
-    auto const& lower = box.lower();
-    auto const& upper = box.upper();
 
-    if (iCell[0] >= lower(0) && iCell[0] <= upper(0))
+
+
+    static std::vector<SAMRAI::hier::Box>
+    destinationBoxes_(SAMRAI::pdat::CellOverlap const& overlap)
     {
-        return true;
+        auto const& boxContainer = overlap.getDestinationBoxContainer();
+        return std::vector<SAMRAI::hier::Box>(std::begin(boxContainer), std::end(boxContainer));
     }
-    return false;
-}
 
-template<>
-inline bool ParticlesData<2>::isInBox_(SAMRAI::hier::Box const& box,
-                                       Particle<2> const& particle) const
-{
-    auto const& iCell = particle.iCell;
 
-    auto const& lower = box.lower();
-    auto const& upper = box.upper();
 
 
-    if (iCell[0] >= lower(0) && iCell[0] <= upper(0))
+    /**
+     * @brief localToShiftedAMR returns the vector to shift a particle cell from a local
+     * index to an AMR offseted index. This function is to be used to shift particles cells
+     * before packing them to the stream.
+     * At the unpack stage, when the destination box is known, one will have to
+     * call AMRToLocal() to finish the index shift to get particles cells into destination local
+     * index space
+     */
+    SAMRAI::hier::IntVector
+    localToShiftedAMR(SAMRAI::hier::Box const& sourceGhostBox,
+                      SAMRAI::hier::Transformation const& transformation) const
     {
-        if (iCell[1] >= lower(1) && iCell[1] <= upper(1))
-        {
-            return true;
-        }
+        SAMRAI::hier::IntVector shift{sourceGhostBox.lower()}; // move to AMR space
+        shift += transformation.getOffset(); // translate AMR indexes with the transfo offset
+        return shift;
     }
-    return false;
-}
 
-template<>
-inline bool ParticlesData<3>::isInBox_(SAMRAI::hier::Box const& box,
-                                       Particle<3> const& particle) const
-{
-    auto const& iCell = particle.iCell;
 
-    auto const& lower = box.lower();
-    auto const& upper = box.upper();
 
 
-    if (iCell[0] >= lower(0) && iCell[0] <= upper(0))
+    /**
+     * @brief localSelectionBox_ takes the intersectionBox, which is in AMR space aligned with
+     * the destination, shifts its AMR index to the source location and moves the shifted AMR
+     * index to local source index space
+     */
+    SAMRAI::hier::Box localSelectionBox_(SAMRAI::hier::Box const& intersectionBox,
+                                         SAMRAI::hier::Box const& sourceBox,
+                                         SAMRAI::hier::Transformation const& transformation) const
     {
-        if (iCell[1] >= lower(1) && iCell[1] <= upper(1))
-        {
-            if (iCell[2] >= lower(2) && iCell[2] <= upper(2))
-            {
-                return true;
-            }
-        }
+        SAMRAI::hier::Box localSelectionSourceBox{intersectionBox};
+        transformation.inverseTransform(localSelectionSourceBox);
+        AMRToLocal(localSelectionSourceBox, sourceBox);
+        return localSelectionSourceBox;
     }
-    return false;
-}
+};
+
 
-template<>
-inline void ParticlesData<1>::shiftParticle_(SAMRAI::hier::IntVector const& shift,
-                                             Particle<1>& particle) const
-{
-    particle.iCell[0] += shift[0];
-}
 
-template<>
-inline void ParticlesData<2>::shiftParticle_(SAMRAI::hier::IntVector const& shift,
-                                             Particle<2>& particle) const
-{
-    particle.iCell[0] += shift[0];
-    particle.iCell[1] += shift[1];
-}
-template<>
-inline void ParticlesData<3>::shiftParticle_(SAMRAI::hier::IntVector const& shift,
-                                             Particle<3>& particle) const
-{
-    particle.iCell[0] += shift[0];
-    particle.iCell[1] += shift[1];
-    particle.iCell[2] += shift[2];
-}
 
 } // namespace PHARE
 
@@ -13,7 +13,7 @@
 
 namespace PHARE
 {
-template<std::size_t dim>
+template<std::size_t dim, typename ParticleArrayT = ParticleArray<dim>>
 class ParticlesDataFactory : public SAMRAI::hier::PatchDataFactory
 
 {
@@ -37,7 +37,7 @@ public:
     virtual std::shared_ptr<SAMRAI::hier::PatchData>
     allocate(const SAMRAI::hier::Patch& patch) const final
     {
-        return std::make_shared<ParticlesData<dim>>(patch.getBox(), d_ghosts);
+        return std::make_shared<ParticlesData<dim, ParticleArrayT>>(patch.getBox(), d_ghosts);
     }
 
     virtual std::shared_ptr<SAMRAI::hier::BoxGeometry>
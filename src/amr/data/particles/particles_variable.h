@@ -7,15 +7,16 @@
 
 namespace PHARE
 {
-template<std::size_t dim>
+template<std::size_t dim, typename ParticleArrayT = ParticleArray<dim>>
 class ParticlesVariable : public SAMRAI::hier::Variable
 {
 public:
     ParticlesVariable(std::string const& name, bool fineBoundaryRepresentsVariable = false,
                       SAMRAI::hier::IntVector ghost
                       = SAMRAI::hier::IntVector{SAMRAI::tbox::Dimension{1}})
-        : SAMRAI::hier::Variable{name, std::make_shared<ParticlesDataFactory<dim>>(
-                                           ghost, fineBoundaryRepresentsVariable)}
+        : SAMRAI::hier::Variable{name,
+                                 std::make_shared<ParticlesDataFactory<dim, ParticleArrayT>>(
+                                     ghost, fineBoundaryRepresentsVariable)}
         , fineBoundaryRepresentsVariable_{fineBoundaryRepresentsVariable}
     {
     }
@@ -0,0 +1,173 @@
+#ifndef PHARE_AMR_TOOLS_LEVEL_RESOURCES_BINDING_H
+#define PHARE_AMR_TOOLS_LEVEL_RESOURCES_BINDING_H
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <SAMRAI/hier/Patch.h>
+#include <SAMRAI/hier/PatchLevel.h>
+
+namespace PHARE
+{
+/** \brief LevelResourcesBinding holds, for all the local patches of a PatchLevel, the pointers
+ * to the resources of several ResourcesUser, so that they can be set patch after patch
+ * without going through the ResourcesManager.
+ *
+ * It is made by ResourcesManager::makeLevelBinding(). Each resource of the ResourcesUsers
+ * and of their sub-resources is a slot, and the table has one row of slot pointers per patch,
+ * filled at construction. A slot holds the address of the pointer by which its ResourcesUser
+ * holds the resource, found once when the binding is made, so that setOnPatch() only assigns
+ * the pointers of a row, without going through the setBuffer() of the ResourcesUsers. reset()
+ * and the destructor put them back to nullptr, as ResourcesGuard does.
+ *
+ * Slots marked fetchOnSet are not put in the table: setOnPatch() gets their pointer from the
+ * patch data each time. Particle slots are such, because ParticlesData::getPointer() also
+ * drops the cell offset tables and overlap selections that moving particles makes stale.
+ *
+ * The table is only valid for the level it was built for: it must be rebuilt after a regrid,
+ * or if the patch data of the resources are reallocated. setOnPatch() throws once the level
+ * the binding was built for has been destroyed.
+ */
+class LevelResourcesBinding
+{
+public:
+    struct Slot
+    {
+        //! assigns data to the pointer of a ResourcesUser at address buffer
+        void (*setBuffer)(void* buffer, void* data);
+
+        //! pointer to the resource of the patch data of the given id on a patch
+        void* (*getData)(SAMRAI::hier::Patch const& patch, int id);
+
+        void* buffer;
+        int id;
+
+        //! true if getData() is to be called by each setOnPatch() rather than once
+        bool fetchOnSet;
+    };
+
+
+    LevelResourcesBinding(std::shared_ptr<SAMRAI::hier::PatchLevel> const& level,
+                          std::vector<Slot> slots)
+        : level_{level}
+        , slots_{std::move(slots)}
+    {
+        for (auto const& patch : *level)
+        {
+            patches_.push_back(patch);
+            for (auto const& slot : slots_)
+            {
+                table_.push_back(slot.fetchOnSet ? nullptr : slot.getData(*patch, slot.id));
+            }
+        }
+    }
+
+
+    ~LevelResourcesBinding() { reset(); }
+
+
+    LevelResourcesBinding(LevelResourcesBinding&& source)
+        : level_{std::move(source.level_)}
+        , slots_{std::move(source.slots_)}
+        , patches_{std::move(source.patches_)}
+        , table_{std::move(source.table_)}
+    {
+        // so that the source does not reset the resources when destroyed
+        source.slots_.clear();
+    }
+
+    LevelResourcesBinding()                             = delete;
+    LevelResourcesBinding(LevelResourcesBinding const&) = delete;
+    LevelResourcesBinding& operator=(LevelResourcesBinding const& source) = delete;
+    LevelResourcesBinding& operator=(LevelResourcesBinding&&) = delete;
+
+
+
+
+    //! number of local patches of the level
+    std::size_t size() const { return patches_.size(); }
+
+
+    SAMRAI::hier::Patch& patch(std::size_t iPatch) { return *patches_[iPatch]; }
+
+
+    //! false once the level the binding was built for has been destroyed, e.g. by a regrid
+    bool isValid() const { return !level_.expired(); }
+
+
+
+
+    //! set the resources of the ResourcesUsers to those of the iPatch-th local patch
+    void setOnPatch(std::size_t iPatch)
+    {
+        if (!isValid())
+        {
+            throw std::runtime_error("LevelResourcesBinding used after its level was destroyed");
+        }
+
+        auto const& patch = *patches_[iPatch];
+        auto const* row   = table_.data() + iPatch * slots_.size();
+        for (std::size_t iSlot = 0; iSlot < slots_.size(); ++iSlot)
+        {
+            auto const& slot = slots_[iSlot];
+            auto* data       = slot.fetchOnSet ? slot.getData(patch, slot.id) : row[iSlot];
+            slot.setBuffer(slot.buffer, data);
+        }
+    }
+
+
+
+
+    //! put all the resources of the ResourcesUsers back to nullptr
+    void reset()
+    {
+        for (auto const& slot : slots_)
+        {
+            slot.setBuffer(slot.buffer, nullptr);
+        }
+    }
+
+
+
+
+    /** \brief the Slot::setBuffer function for the resources of type ResourcesType,
+     * UserFieldType or UserParticleType, the pointer at buffer being of its internal_type_ptr
+     */
+    template<typename ResourcesType>
+    static void setBuffer(void* buffer, void* data)
+    {
+        using internal_type_ptr = typename ResourcesType::internal_type_ptr;
+
+        *static_cast<internal_type_ptr*>(buffer) = static_cast<internal_type_ptr>(data);
+    }
+
+
+    //! the Slot::getData function for the resources of type ResourcesType
+    template<typename ResourcesType>
+    static void* getData(SAMRAI::hier::Patch const& patch, int id)
+    {
+        auto const& patchData = patch.getPatchData(id);
+        return static_cast<typename ResourcesType::patch_data_type*>(patchData.get())
+            ->getPointer();
+    }
+
+
+
+
+private:
+    std::weak_ptr<SAMRAI::hier::PatchLevel> level_;
+    std::vector<Slot> slots_;
+    std::vector<std::shared_ptr<SAMRAI::hier::Patch>> patches_;
+
+    // row iPatch holds the pointers of all slots on the iPatch-th local patch
+    std::vector<void*> table_;
+};
+
+
+
+} // namespace PHARE
+
+#endif
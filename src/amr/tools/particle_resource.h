@@ -17,8 +17,10 @@ struct UserParticleType
 {
     static constexpr std::size_t dimension = ResourcesUser::dimension;
 
-    using variable_type     = ParticlesVariable<dimension>;
-    using patch_data_type   = ParticlesData<dimension>;
+    using particle_array_type = typename ResourcesUser::particle_array_type;
+
+    using variable_type     = ParticlesVariable<dimension, particle_array_type>;
+    using patch_data_type   = ParticlesData<dimension, particle_array_type>;
     using internal_type_ptr = typename ResourcesUser::particle_resource_type*;
 };
 
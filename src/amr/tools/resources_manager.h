@@ -1,13 +1,18 @@
 #ifndef PHARE_AMR_TOOLS_RESOURCES_MANAGER_H
 #define PHARE_AMR_TOOLS_RESOURCES_MANAGER_H
 
+#include <cstddef>
 #include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <SAMRAI/hier/Patch.h>
 #include <SAMRAI/hier/VariableDatabase.h>
 
 #include "field_resource.h"
 #include "hybrid/hybrid_quantities.h"
+#include "level_resources_binding.h"
 #include "particle_resource.h"
 #include "resources_guards.h"
 #include "resources_manager_utilities.h"
@@ -49,6 +54,28 @@ struct ResourcesInfo
     int id;
 };
 
+
+
+/**
+ * \brief ResourcesHandles are the resources a ResourcesUser holds itself (not those of its
+ * sub-resources), bound to the user when it is registered.
+ *
+ * Each Handle is the patch data id of a resource and the address of the pointer by which the
+ * user holds it, so that the pointer can be set without going through setBuffer().
+ */
+struct ResourcesHandles
+{
+    struct Handle
+    {
+        int id;
+        void* buffer;
+    };
+
+    void const* user;
+    std::vector<Handle> fields;
+    std::vector<Handle> particles;
+};
+
 /** \brief ResourcesManager is an adapter between PHARE objects that manipulate
  * data on patches, and the SAMRAI variable database system, storing the data.
  * It is used by PHARE to register data to the samrai system and to get access to it
@@ -98,6 +125,23 @@ struct ResourcesInfo
  *
  * - createResourcesGuard() : used to create a ResourcesGuard.
  *
+ * - makeLevelBinding() : used to create a LevelResourcesBinding, which sets the resources
+ * of ResourcesUsers patch after patch on a whole level from a precomputed pointer table.
+ *
+ * registerResources() binds each ResourcesUser it is given, and each of its sub-resources,
+ * to ResourcesHandles, and gives the user the index of its handles (setResourcesHandle()).
+ * setResources_() then finds the handles of a registered ResourcesUser by this index, and
+ * sets its pointers to the patch data of the bound ids, without asking the user for its
+ * resource names nor looking them up. The handles also hold the address of the user they
+ * are bound to, so that a ResourcesUser moved or copied from a registered one, which has its
+ * index but another address, finds its resources by name instead, as does any other
+ * ResourcesUser with the same resource names, e.g. one built at the address of a destroyed
+ * registered one.
+ *
+ * Besides the resource names and setBuffer(), a ResourcesUser with resources thus gives
+ * getResourcesHandle() and setResourcesHandle(), and getFieldBuffer() or
+ * getParticlesBuffer(), which return a reference to the pointer setBuffer() sets.
+ *
  * One method is rather to be used by SAMRAI derived classes:
  *
  * - allocate()
@@ -139,14 +183,21 @@ public:
     template<typename ResourcesUser>
     void registerResources(ResourcesUser& obj)
     {
-        if constexpr (has_field<ResourcesUser>::value)
+        if constexpr (has_field<ResourcesUser>::value || has_particles<ResourcesUser>::value)
         {
-            registerResources_<ResourcesUser, UserFieldType<GridLayoutT, ResourcesUser>>(obj);
-        }
+            auto const handle = bindHandles_(obj);
 
-        if constexpr (has_particles<ResourcesUser>::value)
-        {
-            registerResources_<ResourcesUser, UserParticleType<ResourcesUser>>(obj);
+            if constexpr (has_field<ResourcesUser>::value)
+            {
+                registerResources_<ResourcesUser, UserFieldType<GridLayoutT, ResourcesUser>>(
+                    obj, handles_[handle].fields);
+            }
+
+            if constexpr (has_particles<ResourcesUser>::value)
+            {
+                registerResources_<ResourcesUser, UserParticleType<ResourcesUser>>(
+                    obj, handles_[handle].particles);
+            }
         }
 
 
@@ -184,14 +235,31 @@ public:
     template<typename ResourcesUser>
     void allocate(ResourcesUser& obj, SAMRAI::hier::Patch& patch) const
     {
-        if constexpr (has_field<ResourcesUser>::value)
-        {
-            allocate_(obj, obj.getFieldNamesAndQuantities(), patch);
-        }
-
-        if constexpr (has_particles<ResourcesUser>::value)
+        if constexpr (has_field<ResourcesUser>::value || has_particles<ResourcesUser>::value)
         {
-            allocate_(obj, obj.getParticleArrayNames(), patch);
+            if (auto const* handles = boundHandles_(obj))
+            {
+                for (auto const& handle : handles->fields)
+                {
+                    patch.allocatePatchData(handle.id);
+                }
+                for (auto const& handle : handles->particles)
+                {
+                    patch.allocatePatchData(handle.id);
+                }
+            }
+            else
+            {
+                if constexpr (has_field<ResourcesUser>::value)
+                {
+                    allocate_(obj, obj.getFieldNamesAndQuantities(), patch);
+                }
+
+                if constexpr (has_particles<ResourcesUser>::value)
+                {
+                    allocate_(obj, obj.getParticleArrayNames(), patch);
+                }
+            }
         }
 
         if constexpr (has_runtime_subresourceuser_list<ResourcesUser>::value)
@@ -233,6 +301,29 @@ public:
 
 
 
+    /** \brief make a LevelResourcesBinding for all passed objects on the local patches
+     * of the level. Use as
+     *
+     * auto binding = makeLevelBinding(level, obj1, obj2, ...);
+     * for (std::size_t iPatch = 0; iPatch < binding.size(); ++iPatch)
+     * {
+     *     binding.setOnPatch(iPatch);
+     *     ...
+     * }
+     */
+    template<typename... ResourcesUsers>
+    LevelResourcesBinding makeLevelBinding(std::shared_ptr<SAMRAI::hier::PatchLevel> const& level,
+                                           ResourcesUsers&... resourcesUsers) const
+    {
+        std::vector<LevelResourcesBinding::Slot> slots;
+        (addLevelBindingSlots_(resourcesUsers, slots), ...);
+
+        return LevelResourcesBinding{level, std::move(slots)};
+    }
+
+
+
+
 private:
     // The function getResourcesPointer_ is the one that depending
     // on NullOrResourcePtr will choose to return
@@ -242,12 +333,12 @@ private:
      * is used by getResourcesPointer_ when user code wants the pointer to the data
      */
     template<typename ResourceType>
-    auto getPatchData_(ResourceType resourceType, ResourcesInfo const& resourcesVariableInfo,
-                       SAMRAI::hier::Patch const& patch) const
+    auto getPatchData_(ResourceType resourceType, int id, SAMRAI::hier::Patch const& patch) const
     {
-        auto patchData = patch.getPatchData(resourcesVariableInfo.variable, context_);
-        return (std::dynamic_pointer_cast<typename ResourceType::patch_data_type>(patchData))
-            ->getPointer();
+        // the id has been registered with a variable of ResourceType, so that the patch data
+        // is known to be a ResourceType::patch_data_type
+        auto const& patchData = patch.getPatchData(id);
+        return static_cast<typename ResourceType::patch_data_type*>(patchData.get())->getPointer();
     }
 
 
@@ -257,12 +348,12 @@ private:
      * the client code wants to get a pointer to a patch data resource
      */
     template<typename ResourceType, typename RequestedPtr>
-    auto getResourcesPointer_(ResourceType resourceType, ResourcesInfo const& resourcesVariableInfo,
+    auto getResourcesPointer_(ResourceType resourceType, int id,
                               SAMRAI::hier::Patch const& patch) const
     {
         if constexpr (std::is_same_v<RequestedPtr, UseResourcePtr>)
         {
-            return getPatchData_(resourceType, resourcesVariableInfo, patch);
+            return getPatchData_(resourceType, id, patch);
         }
 
         else if constexpr (std::is_same_v<RequestedPtr, UseNullPtr>)
@@ -278,16 +369,37 @@ private:
     void setResources_(ResourcesUser& obj, NullOrResourcePtr nullOrResourcePtr,
                        SAMRAI::hier::Patch const& patch) const
     {
-        if constexpr (has_field<ResourcesUser>::value)
-        {
-            setResourcesInternal_(obj, UserFieldType<GridLayoutT, ResourcesUser>{},
-                                  obj.getFieldNamesAndQuantities(), patch, nullOrResourcePtr);
-        }
-
-        if constexpr (has_particles<ResourcesUser>::value)
+        if constexpr (has_field<ResourcesUser>::value || has_particles<ResourcesUser>::value)
         {
-            setResourcesInternal_(obj, UserParticleType<ResourcesUser>{},
-                                  obj.getParticleArrayNames(), patch, nullOrResourcePtr);
+            if (auto const* handles = boundHandles_(obj))
+            {
+                if constexpr (has_field<ResourcesUser>::value)
+                {
+                    setBoundResources_(UserFieldType<GridLayoutT, ResourcesUser>{},
+                                       handles->fields, patch, nullOrResourcePtr);
+                }
+
+                if constexpr (has_particles<ResourcesUser>::value)
+                {
+                    setBoundResources_(UserParticleType<ResourcesUser>{}, handles->particles,
+                                       patch, nullOrResourcePtr);
+                }
+            }
+            else
+            {
+                if constexpr (has_field<ResourcesUser>::value)
+                {
+                    setResourcesInternal_(obj, UserFieldType<GridLayoutT, ResourcesUser>{},
+                                          obj.getFieldNamesAndQuantities(), patch,
+                                          nullOrResourcePtr);
+                }
+
+                if constexpr (has_particles<ResourcesUser>::value)
+                {
+                    setResourcesInternal_(obj, UserParticleType<ResourcesUser>{},
+                                          obj.getParticleArrayNames(), patch, nullOrResourcePtr);
+                }
+            }
         }
 
 
@@ -319,8 +431,10 @@ private:
 
 
     template<typename ResourcesUser, typename ResourcesType>
-    void registerResources_(ResourcesUser const& user)
+    void registerResources_(ResourcesUser& user, std::vector<ResourcesHandles::Handle>& handles)
     {
+        handles.clear();
+
         if constexpr (isUserFieldType<GridLayoutT, ResourcesUser, ResourcesType>::value)
         {
             auto const& resourcesProperties = user.getFieldNamesAndQuantities();
@@ -336,7 +450,8 @@ private:
                 info.id = variableDatabase_->registerVariableAndContext(
                     info.variable, context_, SAMRAI::hier::IntVector::getZero(dimension_));
 
-                nameToResourceInfo_.emplace(resourcesName, info);
+                auto const& registered = nameToResourceInfo_.emplace(resourcesName, info).first;
+                handles.push_back({registered->second.id, &user.getFieldBuffer(resourcesName)});
             }
         }
 
@@ -354,7 +469,8 @@ private:
                 info.id = variableDatabase_->registerVariableAndContext(
                     info.variable, context_, SAMRAI::hier::IntVector::getZero(dimension_));
 
-                nameToResourceInfo_.emplace(name, info);
+                auto const& registered = nameToResourceInfo_.emplace(name, info).first;
+                handles.push_back({registered->second.id, &user.getParticlesBuffer(name)});
             }
         }
     }
@@ -377,7 +493,7 @@ private:
             if (resourceInfoIt != nameToResourceInfo_.end())
             {
                 auto data = getResourcesPointer_<ResourcesType, RequestedPtr>(
-                    resourceType, resourceInfoIt->second, patch);
+                    resourceType, resourceInfoIt->second.id, patch);
 
                 obj.setBuffer(resourcesName, data);
             }
@@ -391,6 +507,157 @@ private:
 
 
 
+    //! \brief same as setResourcesInternal_ for the handles a ResourcesUser is bound to
+    template<typename ResourcesType, typename RequestedPtr>
+    void setBoundResources_(ResourcesType resourceType,
+                            std::vector<ResourcesHandles::Handle> const& handles,
+                            SAMRAI::hier::Patch const& patch, RequestedPtr) const
+    {
+        using internal_type_ptr = typename ResourcesType::internal_type_ptr;
+
+        for (auto const& handle : handles)
+        {
+            *static_cast<internal_type_ptr*>(handle.buffer)
+                = getResourcesPointer_<ResourcesType, RequestedPtr>(resourceType, handle.id,
+                                                                    patch);
+        }
+    }
+
+
+
+
+    /** \brief the handles bound to a registered ResourcesUser, or nullptr if it has none, or
+     * if they are bound to another address, e.g. because the ResourcesUser is a copy
+     */
+    template<typename ResourcesUser>
+    ResourcesHandles const* boundHandles_(ResourcesUser const& obj) const
+    {
+        auto const handle = obj.getResourcesHandle();
+        if (handle < 0 || static_cast<std::size_t>(handle) >= handles_.size()
+            || handles_[handle].user != &obj)
+        {
+            return nullptr;
+        }
+        return &handles_[handle];
+    }
+
+
+
+
+    //! \brief the index of the handles of a ResourcesUser being registered
+    template<typename ResourcesUser>
+    int bindHandles_(ResourcesUser& obj)
+    {
+        if (boundHandles_(obj) == nullptr)
+        {
+            handles_.push_back({&obj, {}, {}});
+            obj.setResourcesHandle(static_cast<int>(handles_.size() - 1));
+        }
+        return obj.getResourcesHandle();
+    }
+
+
+
+
+    //! \brief the handles of a registered ResourcesUser, or those of its resource names
+    template<typename ResourcesUser>
+    ResourcesHandles handlesOf_(ResourcesUser& obj) const
+    {
+        if (auto const* handles = boundHandles_(obj))
+        {
+            return *handles;
+        }
+
+        ResourcesHandles namedHandles{&obj, {}, {}};
+        auto idOf = [this](std::string const& name) {
+            auto const resourceInfoIt = nameToResourceInfo_.find(name);
+            if (resourceInfoIt == nameToResourceInfo_.end())
+            {
+                throw std::runtime_error("Resources not found !");
+            }
+            return resourceInfoIt->second.id;
+        };
+
+        if constexpr (has_field<ResourcesUser>::value)
+        {
+            for (auto const& properties : obj.getFieldNamesAndQuantities())
+            {
+                namedHandles.fields.push_back(
+                    {idOf(properties.name), &obj.getFieldBuffer(properties.name)});
+            }
+        }
+
+        if constexpr (has_particles<ResourcesUser>::value)
+        {
+            for (auto const& properties : obj.getParticleArrayNames())
+            {
+                namedHandles.particles.push_back(
+                    {idOf(properties.name), &obj.getParticlesBuffer(properties.name)});
+            }
+        }
+
+        return namedHandles;
+    }
+
+
+
+
+    //! \brief add a slot for each resource of the ResourcesUser and of its sub-resources
+    template<typename ResourcesUser>
+    void addLevelBindingSlots_(ResourcesUser& obj,
+                               std::vector<LevelResourcesBinding::Slot>& slots) const
+    {
+        if constexpr (has_field<ResourcesUser>::value || has_particles<ResourcesUser>::value)
+        {
+            auto const handles = handlesOf_(obj);
+
+            if constexpr (has_field<ResourcesUser>::value)
+            {
+                using ResourcesType = UserFieldType<GridLayoutT, ResourcesUser>;
+                auto setBuffer = &LevelResourcesBinding::setBuffer<ResourcesType>;
+                auto getData   = &LevelResourcesBinding::getData<ResourcesType>;
+                for (auto const& handle : handles.fields)
+                {
+                    slots.push_back({setBuffer, getData, handle.buffer, handle.id, false});
+                }
+            }
+
+            if constexpr (has_particles<ResourcesUser>::value)
+            {
+                using ResourcesType = UserParticleType<ResourcesUser>;
+                auto setBuffer = &LevelResourcesBinding::setBuffer<ResourcesType>;
+                auto getData   = &LevelResourcesBinding::getData<ResourcesType>;
+                for (auto const& handle : handles.particles)
+                {
+                    slots.push_back({setBuffer, getData, handle.buffer, handle.id, true});
+                }
+            }
+        }
+
+        if constexpr (has_runtime_subresourceuser_list<ResourcesUser>::value)
+        {
+            auto&& resourcesUsers = obj.getRunTimeResourcesUserList();
+            for (auto& resourcesUser : resourcesUsers)
+            {
+                this->addLevelBindingSlots_(resourcesUser, slots);
+            }
+        }
+
+        if constexpr (has_compiletime_subresourcesuser_list<ResourcesUser>::value)
+        {
+            auto&& subResources = obj.getCompileTimeResourcesUserList();
+
+            std::apply(
+                [this, &slots](auto&... subResource) {
+                    (this->addLevelBindingSlots_(subResource, slots), ...);
+                },
+                subResources);
+        }
+    }
+
+
+
+
     //! \brief Allocate the data on the given level
     template<typename ResourcesUser, typename ResourcesProperties>
     void allocate_(ResourcesUser const& obj, ResourcesProperties const& resourcesProperties,
@@ -417,6 +684,9 @@ private:
     SAMRAI::tbox::Dimension dimension_;
     std::map<std::string, ResourcesInfo> nameToResourceInfo_;
 
+    // indexed by the handle given to each registered ResourcesUser
+    std::vector<ResourcesHandles> handles_;
+
     template<typename ResourcesManager, typename... ResourcesUsers>
     friend class ResourcesGuard;
 };
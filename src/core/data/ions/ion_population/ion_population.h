@@ -119,6 +119,26 @@ public:
 
 
 
+    VecField const& flux() const
+    {
+        if (isUsable())
+        {
+            return flux_;
+        }
+        else
+        {
+            throw std::runtime_error("Error - cannot provide access to flux");
+        }
+    }
+
+
+    VecField& flux()
+    {
+        return const_cast<VecField&>(static_cast<const IonPopulation*>(this)->flux());
+    }
+
+
+
     //-------------------------------------------------------------------------
     //                  start the ResourcesUser interface
     //-------------------------------------------------------------------------
@@ -181,6 +201,37 @@ public:
 
 
 
+    //! the particles pointer setBuffer() sets for bufferName, to be set directly
+    ParticlesPack<ParticleArray>*& getParticlesBuffer(std::string const& bufferName)
+    {
+        if (bufferName == name_)
+        {
+            return particles_;
+        }
+        throw std::runtime_error("Error - invalid particle resource name");
+    }
+
+
+
+    //! the density pointer setBuffer() sets for bufferName, to be set directly
+    field_type*& getFieldBuffer(std::string const& bufferName)
+    {
+        if (bufferName == name_ + "_rho")
+        {
+            return rho_;
+        }
+        throw std::runtime_error("Error - invalid density buffer name");
+    }
+
+
+
+    //! index of the handles the ResourcesManager bound this population to, -1 if none
+    int getResourcesHandle() const { return resourcesHandle_; }
+
+    void setResourcesHandle(int handle) { resourcesHandle_ = handle; }
+
+
+
     auto getCompileTimeResourcesUserList() { return std::forward_as_tuple(flux_); }
 
 
@@ -196,6 +247,7 @@ private:
     VecField flux_;
     field_type* rho_{nullptr};
     ParticlesPack<ParticleArray>* particles_{nullptr};
+    int resourcesHandle_{-1};
 };
 
 } // namespace PHARE
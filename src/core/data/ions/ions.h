@@ -167,6 +167,25 @@ public:
 
 
 
+    //! the density pointer setBuffer() sets for bufferName, to be set directly
+    field_type*& getFieldBuffer(std::string const& bufferName)
+    {
+        if (bufferName == name_ + "_rho")
+        {
+            return rho_;
+        }
+        throw std::runtime_error("Error - invalid density buffer name");
+    }
+
+
+
+    //! index of the handles the ResourcesManager bound these Ions to, -1 if none
+    int getResourcesHandle() const { return resourcesHandle_; }
+
+    void setResourcesHandle(int handle) { resourcesHandle_ = handle; }
+
+
+
     std::vector<IonPopulation>& getRunTimeResourcesUserList() { return populations_; }
 
     auto getCompileTimeResourcesUserList() { return std::forward_as_tuple(bulkVelocity_); }
@@ -180,6 +199,7 @@ public:
 private:
     std::string name_;
     field_type* rho_{nullptr};
+    int resourcesHandle_{-1};
     vecfield_type bulkVelocity_;
     std::vector<IonPopulation> populations_; // TODO we have to name this so they are unique
                                              // although only 1 Ions should exist.
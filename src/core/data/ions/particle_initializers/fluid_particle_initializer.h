@@ -1,22 +1,30 @@
 #ifndef PHARE_FLUID_PARTICLE_INITIALIZER_H
 #define PHARE_FLUID_PARTICLE_INITIALIZER_H
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <random>
+#include <vector>
 
 #include "data/grid/gridlayoutdefs.h"
+#include "data/ions/particle_initializers/maxwellian_sampler.h"
 #include "data/ions/particle_initializers/particle_initializer.h"
 #include "data/particles/particle.h"
 #include "hybrid/hybrid_quantities.h"
 #include "utilities/function/function.h"
+#include "utilities/parallel/parallel_for.h"
 #include "utilities/point/point.h"
+#include "utilities/random/philox.h"
 #include "utilities/types.h"
 
 namespace PHARE
 {
 void maxwellianVelocity(std::array<double, 3> V, std::array<double, 3> Vth,
-                        std::mt19937_64 generator, std::array<double, 3>& partVelocity);
+                        std::mt19937_64& generator, std::array<double, 3>& partVelocity);
 
 
 std::array<double, 3> basisTransform(const std::array<std::array<double, 3>, 3> basis,
@@ -29,6 +37,22 @@ void localMagneticBasis(std::array<double, 3> B, std::array<std::array<double, 3
 
 /** @brief a FluidParticleInitializer is a ParticleInitializer that loads particles from a local
  * Maxwellian distribution given density, bulk velocity and thermal velocity profiles.
+ *
+ * Random numbers come from a Philox4x32 generator keyed by the seed, and the counter of each
+ * draw is made of the AMR index of the cell and of the index of the particle in the cell.
+ * The particles loaded in a cell therefore only depend on the seed and on the cell, and not
+ * on the patch the cell belongs to nor on the order in which cells are loaded.
+ *
+ * The number of particles loaded in a cell is either nbrParticlesPerCell, or, with
+ * ParticleCount::Density, nbrParticlesPerCell times the density of the cell, rounded to the
+ * nearest integer. Particles of a cell share the weight density*cellVolume/nbrParticles.
+ *
+ * Loading has two stages. The profiles are first evaluated at the center of each cell, with
+ * one batched call per profile made in the calling thread since profiles are not required
+ * to be thread safe, and a prefix sum of the numbers of particles of the cells gives the
+ * slice of the array of each cell. The particle array is then resized once, and particles
+ * are written in place, the particles being split in chunks filled concurrently by
+ * nbrThreads threads. Particles are the same whatever the number of threads.
  */
 template<typename ParticleArray, typename GridLayout>
 class FluidParticleInitializer : public ParticleInitializer<ParticleArray, GridLayout>
@@ -42,7 +66,9 @@ public:
                              std::unique_ptr<VectorFunction<dimension>> thermalVelocity,
                              double particleCharge, uint32 nbrParticlesPerCell,
                              Basis basis = Basis::Cartesian,
-                             std::unique_ptr<VectorFunction<dimension>> magneticField = nullptr)
+                             std::unique_ptr<VectorFunction<dimension>> magneticField = nullptr,
+                             uint64 seed = 1, std::size_t nbrThreads = 1,
+                             ParticleCount particleCount = ParticleCount::Uniform)
         : density_{std::move(density)}
         , bulkVelocity_{std::move(bulkVelocity)}
         , thermalVelocity_{std::move(thermalVelocity)}
@@ -50,6 +76,9 @@ public:
         , nbrParticlePerCell_{nbrParticlesPerCell}
         , basis_{basis}
         , magneticField_{std::move(magneticField)}
+        , seed_{seed}
+        , nbrThreads_{std::max(nbrThreads, std::size_t{1})}
+        , particleCount_{particleCount}
     {
     }
 
@@ -60,18 +89,30 @@ public:
      */
     virtual void loadParticles(ParticleArray& particles, GridLayout const& layout) const override
     {
-        if constexpr (dimension == 1)
-        {
-            loadParticles1D_(particles, layout);
-        }
-        else if constexpr (dimension == 2)
-        {
-            loadParticles2D_(particles, layout);
-        }
-        else if constexpr (dimension == 3)
+        auto const cells = cellsToLoad_(layout);
+
+        // cellOffsets[iCell] is the index of the first particle of the cell in the new
+        // particles, cellOffsets[cells.size()] the number of new particles
+        std::vector<std::size_t> cellOffsets(cells.size() + 1, 0);
+        for (std::size_t iCell = 0; iCell < cells.size(); ++iCell)
         {
-            loadParticles3D_(particles, layout);
+            cellOffsets[iCell + 1] = cellOffsets[iCell] + cells[iCell].nbrParticles;
         }
+
+        auto const firstParticle = particles.size();
+        auto const nbrParticles  = cellOffsets.back();
+
+        particles.resize(firstParticle + nbrParticles);
+
+        auto const nbrChunks = std::max(
+            std::size_t{1}, std::min(nbrThreads_, nbrParticles / minParticlesPerThread_));
+
+        // chunks are ranges of particles, a cell may be loaded by several chunks
+        parallelForChunks(nbrParticles, nbrChunks,
+                          [&](std::size_t first, std::size_t last, std::size_t) {
+                              loadRange_(first, last, cells, cellOffsets, particles,
+                                         firstParticle);
+                          });
     }
 
 
@@ -80,173 +121,206 @@ public:
 
 
 private:
-    void loadParticles1D_(ParticleArray& particles, GridLayout const& layout) const
+    static constexpr std::size_t minParticlesPerThread_ = 4096;
+
+    // number of Philox4x32 draws per particle: two for the velocity, one for the position
+    static constexpr uint32 nbrDraws_ = 3;
+
+
+    //! what is needed to load the particles of a cell, computed from the profiles
+    struct CellToLoad
     {
-        auto const meshSize = layout.meshSize();
-        auto const& dx      = meshSize[0];
+        std::array<int32, dimension> localIndex;
+        std::array<int32, dimension> AMRIndex;
+        uint32 nbrParticles;
+        double weight;
+        std::array<double, 3> V;
+        std::array<double, 3> Vth;
+        std::array<std::array<double, 3>, 3> basis;
+    };
 
-        /* get indices start and stop. we take primal/primal/primal because
-           that is what GridLayout::cellCenteredCoordinate() requires */
-        uint32 ix0 = layout.physicalStartIndex(QtyCentering::primal, Direction::X);
-        uint32 ix1 = layout.physicalEndIndex(QtyCentering::primal, Direction::X);
 
-        double cellVolume = dx;
-        Point origin      = layout.origin();
 
-        // random seed and generator needed to load maxwellian velocity
-        // and random position with the cell
-        std::random_device randSeed;
-        // std::mt19937_64 generator(randSeed());
-        std::mt19937_64 generator(1); // TODO constant seed should be usable for Debug mode.
+    /* evaluate the profiles at the centers of all the physical cells of the layout. We take
+       primal indices because that is what GridLayout::cellCenteredCoordinates() requires,
+       therefore the physical end index must be excluded */
+    std::vector<CellToLoad> cellsToLoad_(GridLayout const& layout) const
+    {
+        auto const meshSize = layout.meshSize();
+        auto const origin   = layout.origin();
 
-        // beware: we're looping over the cell but use primal indices because of
-        // GridLayout::cellCenteredCoordinates
-        // therefore i(x,y,z)1 must be excluded.
+        std::array<uint32, dimension> start;
+        std::array<uint32, dimension> end;
+        std::array<int32, dimension> localToAMR;
 
-        // grab references for convenience
-        auto& density         = *density_;
-        auto& bulkVelocity    = *bulkVelocity_;
-        auto& thermalVelocity = *thermalVelocity_;
-        auto& magneticField   = *magneticField_;
+        double cellVolume    = 1.;
+        std::size_t nbrCells = 1;
 
-        for (uint32 ix = ix0; ix < ix1; ++ix)
+        for (auto iDim = 0u; iDim < dimension; ++iDim)
         {
-            double n;                  // cell centered density
-            std::array<double, 3> Vth; // cell centered thermal speed
-            std::array<double, 3> V;   // cell centered bulk velocity
-            std::array<double, 3> particleVelocity;
-            std::array<std::array<double, 3>, 3> basis;
+            auto const direction = static_cast<Direction>(iDim);
 
-            // get the coordinate of the current cell
-            auto coord = layout.cellCenteredCoordinates(ix);
-            auto x     = coord[0];
+            start[iDim] = layout.physicalStartIndex(QtyCentering::primal, direction);
+            end[iDim]   = layout.physicalEndIndex(QtyCentering::primal, direction);
 
-            // now get density, velocity and thermal speed values
-            n   = density(x);
-            V   = bulkVelocity(x);
-            Vth = thermalVelocity(x);
+            localToAMR[iDim] = static_cast<int32>(std::lround(origin[iDim] / meshSize[iDim]))
+                               - static_cast<int32>(start[iDim]);
 
-            // weight for all particles in this cell
-            auto cellWeight = n * cellVolume / nbrParticlePerCell_;
+            cellVolume *= meshSize[iDim];
+            nbrCells *= end[iDim] - start[iDim];
+        }
 
-            std::uniform_real_distribution<float> randPosX(0., 1.);
+        std::vector<CellToLoad> cells(nbrCells);
+        std::array<std::vector<double>, dimension> coords;
+        for (auto& coord : coords)
+        {
+            coord.resize(nbrCells);
+        }
 
-            if (basis_ == Basis::Magnetic)
+        // cells are visited with the last direction varying fastest
+        std::array<uint32, dimension> index = start;
+        for (std::size_t iCell = 0; iCell < nbrCells; ++iCell)
+        {
+            auto& cell       = cells[iCell];
+            auto const coord = cellCenteredCoordinates_(layout, index);
+
+            for (auto iDim = 0u; iDim < dimension; ++iDim)
             {
-                auto B = magneticField(x);
-                localMagneticBasis(B, basis);
+                cell.localIndex[iDim] = static_cast<int32>(index[iDim]);
+                cell.AMRIndex[iDim]   = cell.localIndex[iDim] + localToAMR[iDim];
+                coords[iDim][iCell]   = coord[iDim];
             }
 
-            for (uint32 ipart = 0; ipart < nbrParticlePerCell_; ++ipart)
+            for (auto iDim = dimension; iDim-- > 0;)
             {
-                maxwellianVelocity(V, Vth, generator, particleVelocity);
-
-                if (basis_ == Basis::Magnetic)
+                if (++index[iDim] < end[iDim])
                 {
-                    particleVelocity = basisTransform(basis, particleVelocity);
+                    break;
                 }
+                index[iDim] = start[iDim];
+            }
+        }
+
+        // profiles are evaluated on all the cells at once
+        std::vector<double> densities;
+        std::vector<std::array<double, 3>> bulkVelocities;
+        std::vector<std::array<double, 3>> thermalVelocities;
+        std::vector<std::array<double, 3>> magneticFields;
 
-                std::array<float, dimension> delta = {{randPosX(generator)}};
+        evaluate_(*density_, coords, densities);
+        evaluate_(*bulkVelocity_, coords, bulkVelocities);
+        evaluate_(*thermalVelocity_, coords, thermalVelocities);
+
+        if (basis_ == Basis::Magnetic)
+        {
+            evaluate_(*magneticField_, coords, magneticFields);
+        }
+
+        for (std::size_t iCell = 0; iCell < nbrCells; ++iCell)
+        {
+            auto& cell = cells[iCell];
 
-                Particle<dimension> tmpParticle;
-                tmpParticle.weight = cellWeight;
-                tmpParticle.charge = particleCharge_;
-                tmpParticle.iCell  = {{static_cast<int32>(ix)}};
-                tmpParticle.delta  = delta;
-                tmpParticle.v      = particleVelocity;
+            // a negative density, e.g. from a profile undershooting 0, loads no particle
+            auto const n = std::max(densities[iCell], 0.);
 
-                particles.push_back(std::move(tmpParticle));
+            cell.nbrParticles = particleCount_ == ParticleCount::Uniform
+                                    ? nbrParticlePerCell_
+                                    : static_cast<uint32>(std::lround(n * nbrParticlePerCell_));
+
+            cell.weight = cell.nbrParticles > 0 ? n * cellVolume / cell.nbrParticles : 0.;
+            cell.V      = bulkVelocities[iCell];
+            cell.Vth    = thermalVelocities[iCell];
+
+            if (basis_ == Basis::Magnetic)
+            {
+                localMagneticBasis(magneticFields[iCell], cell.basis);
             }
         }
-    }
 
+        return cells;
+    }
 
 
 
-    void loadParticles2D_(ParticleArray& particles, GridLayout const& layout) const
+    //! write the new particles [first, last[ in particles, from index firstParticle on
+    void loadRange_(std::size_t first, std::size_t last, std::vector<CellToLoad> const& cells,
+                    std::vector<std::size_t> const& cellOffsets, ParticleArray& particles,
+                    std::size_t firstParticle) const
     {
-        auto const meshSize = layout.meshSize();
-        auto const& dx      = meshSize[0];
-        auto const& dy      = meshSize[1];
+        // last cell starting at or before the first particle, i.e. the cell holding it
+        auto iCell = static_cast<std::size_t>(
+            std::upper_bound(std::begin(cellOffsets), std::end(cellOffsets), first)
+            - std::begin(cellOffsets) - 1);
 
-        /* get indices start and stop. we take primal/primal/primal because
-           that is what GridLayout::cellCenteredCoordinate() requires */
-        auto ix0 = layout.physicalStartIndex(QtyCentering::primal, Direction::X);
-        auto ix1 = layout.physicalEndIndex(QtyCentering::primal, Direction::X);
-        auto iy0 = layout.physicalStartIndex(QtyCentering::primal, Direction::Y);
-        auto iy1 = layout.physicalEndIndex(QtyCentering::primal, Direction::Y);
+        MaxwellianSampler sampler{Philox4x32{seed_}};
 
-        auto cellVolume = dx * dy;
-        auto origin     = layout.origin();
+        for (auto iPart = first; iPart < last; ++iCell)
+        {
+            auto const cellOffset = cellOffsets[iCell];
+            auto const cellEnd    = std::min(last, cellOffsets[iCell + 1]);
 
-        // random seed and generator needed to load maxwellian velocity
-        // and random position with the cell
-        std::random_device randSeed;
-        std::mt19937_64 generator(randSeed());
+            loadCell_(cells[iCell], iPart - cellOffset, cellEnd - cellOffset, particles,
+                      firstParticle + cellOffset, sampler);
 
-        // beware: we're looping over the cell but use primal indices because of
-        // GridLayout::cellCenteredCoordinates
-        // therefore i(x,y,z)1 must be excluded.
+            iPart = cellEnd;
+        }
+    }
 
-        // grab references for convenience
-        auto& density         = *density_;
-        auto& bulkVelocity    = *bulkVelocity_;
-        auto& thermalVelocity = *thermalVelocity_;
-        auto& magneticField   = *magneticField_;
 
 
-        for (uint32 ix = ix0; ix < ix1; ++ix)
+    /** write the particles [firstInCell, lastInCell[ of the cell in particles, the first
+     * particle of the cell being at index firstParticle. Velocities are drawn by blocks of
+     * MaxwellianSampler::blockSize particles.
+     */
+    void loadCell_(CellToLoad const& cell, std::size_t firstInCell, std::size_t lastInCell,
+                   ParticleArray& particles, std::size_t firstParticle,
+                   MaxwellianSampler& sampler) const
+    {
+        Philox4x32 const generator{seed_};
+
+        Philox4x32::counter_type counter{{0u, 0u, 0u, 0u}};
+        for (auto iDim = 0u; iDim < dimension; ++iDim)
         {
-            for (uint32 iy = iy0; iy < iy1; ++iy)
-            {
-                double n;                  // cell centered density
-                std::array<double, 3> Vth; // cell centered thermal speed
-                std::array<double, 3> V;   // cell centered bulk velocity
-                std::array<double, 3> particleVelocity;
-                std::array<std::array<double, 3>, 3> basis;
-
-                // get the coordinate of the current cell
-                auto coord = layout.cellCenteredCoordinates(ix, iy);
-                auto x     = coord[0];
-                auto y     = coord[1];
-
-                // now get density, velocity and thermal speed values
-                n   = density(x, y);
-                V   = bulkVelocity(x, y);
-                Vth = thermalVelocity(x, y);
-
-                // weight for all particles in this cell
-                auto cellWeight = n * cellVolume / nbrParticlePerCell_;
-                std::uniform_real_distribution<float> randPosX(0., 1.);
-                std::uniform_real_distribution<float> randPosY(0., 1.);
-
-                if (basis_ == Basis::Magnetic)
-                {
-                    auto B = magneticField(x, y, origin.z);
-                    localMagneticBasis(B, basis);
-                }
+            counter[iDim + 1] = static_cast<uint32>(cell.AMRIndex[iDim]);
+        }
 
+        MaxwellianSampler::VelocityBlock velocities;
 
-                for (uint32 ipart = 0; ipart < nbrParticlePerCell_; ++ipart)
-                {
-                    maxwellianVelocity(V, Vth, generator, particleVelocity);
+        for (auto blockStart = firstInCell; blockStart < lastInCell;
+             blockStart += MaxwellianSampler::blockSize)
+        {
+            auto const blockSize
+                = std::min(MaxwellianSampler::blockSize, lastInCell - blockStart);
 
-                    if (basis_ == Basis::Magnetic)
-                    {
-                        particleVelocity = basisTransform(basis, particleVelocity);
-                    }
+            sampler(counter, static_cast<uint32>(blockStart) * nbrDraws_, nbrDraws_, blockSize,
+                    cell.V, cell.Vth, velocities);
 
-                    std::array<float, dimension> delta
-                        = {{randPosX(generator), randPosY(generator)}};
+            if (basis_ == Basis::Magnetic)
+            {
+                MaxwellianSampler::rotate(cell.basis, blockSize, velocities);
+            }
+
+            for (std::size_t iBlock = 0; iBlock < blockSize; ++iBlock)
+            {
+                auto const iPart = blockStart + iBlock;
+
+                // the third draw of the particle gives its position
+                counter[0]              = static_cast<uint32>(iPart) * nbrDraws_ + 2;
+                auto const positionBits = generator(counter);
+
+                // the particle has been value-initialized by the resize of the array
+                auto&& particle = particles[firstParticle + iPart];
 
-                    Particle<dimension> tmpParticle;
-                    tmpParticle.weight = cellWeight;
-                    tmpParticle.charge = particleCharge_;
-                    tmpParticle.iCell  = {{static_cast<int32>(ix), static_cast<int32>(iy)}};
-                    tmpParticle.delta  = delta;
-                    tmpParticle.v      = particleVelocity;
+                particle.weight = cell.weight;
+                particle.charge = particleCharge_;
+                particle.iCell  = cell.localIndex;
+                particle.v[0]   = velocities.vx[iBlock];
+                particle.v[1]   = velocities.vy[iBlock];
+                particle.v[2]   = velocities.vz[iBlock];
 
-                    particles.push_back(std::move(tmpParticle));
+                for (auto iDim = 0u; iDim < dimension; ++iDim)
+                {
+                    particle.delta[iDim] = uniformFloat(positionBits[iDim]);
                 }
             }
         }
@@ -254,102 +328,42 @@ private:
 
 
 
+    static Point<double, dimension>
+    cellCenteredCoordinates_(GridLayout const& layout, std::array<uint32, dimension> const& index)
+    {
+        if constexpr (dimension == 1)
+        {
+            return layout.cellCenteredCoordinates(index[0]);
+        }
+        else if constexpr (dimension == 2)
+        {
+            return layout.cellCenteredCoordinates(index[0], index[1]);
+        }
+        else if constexpr (dimension == 3)
+        {
+            return layout.cellCenteredCoordinates(index[0], index[1], index[2]);
+        }
+    }
+
+
 
-    void loadParticles3D_(ParticleArray& particles, GridLayout const& layout) const
+    template<typename Function, typename Values>
+    static void evaluate_(Function& function,
+                          std::array<std::vector<double>, dimension> const& coords,
+                          Values& values)
     {
-        auto const meshSize = layout.meshSize();
-        auto const& dx      = meshSize[0];
-        auto const& dy      = meshSize[1];
-        auto const& dz      = meshSize[2];
-
-        /* get indices start and stop. we take primal/primal/primal because
-           that is what GridLayout::cellCenteredCoordinate() requires */
-        auto ix0 = layout.physicalStartIndex(QtyCentering::primal, Direction::X);
-        auto ix1 = layout.physicalEndIndex(QtyCentering::primal, Direction::X);
-        auto iy0 = layout.physicalStartIndex(QtyCentering::primal, Direction::Y);
-        auto iy1 = layout.physicalEndIndex(QtyCentering::primal, Direction::Y);
-        auto iz0 = layout.physicalStartIndex(QtyCentering::primal, Direction::Z);
-        auto iz1 = layout.physicalEndIndex(QtyCentering::primal, Direction::Z);
-
-        double cellVolume = dx * dy * dz;
-
-        // random seed and generator needed to load maxwellian velocity
-        // and random position with the cell
-        std::random_device randSeed;
-        std::mt19937_64 generator(randSeed());
-
-        // beware: we're looping over the cell but use primal indices because of
-        // GridLayout::cellCenteredCoordinates
-        // therefore i(x,y,z)1 must be excluded.
-
-        // grab references for convenience
-        auto& density         = *density_;
-        auto& bulkVelocity    = *bulkVelocity_;
-        auto& thermalVelocity = *thermalVelocity_;
-        auto& magneticField   = *magneticField_;
-
-        for (uint32 ix = ix0; ix < ix1; ++ix)
+        if constexpr (dimension == 1)
         {
-            for (uint32 iy = iy0; iy < iy1; ++iy)
-            {
-                for (uint32 iz = iz0; iz < iz1; ++iz)
-                {
-                    double n;                  // cell centered density
-                    std::array<double, 3> Vth; // cell centered thermal speed
-                    std::array<double, 3> V;   // cell centered bulk velocity
-                    std::array<double, 3> particleVelocity;
-                    std::array<std::array<double, 3>, 3> basis;
-
-                    // get the coordinate of the current cell
-                    auto coord = layout.cellCenteredCoordinates(ix, iy, iz);
-                    auto x     = coord[0];
-                    auto y     = coord[1];
-                    auto z     = coord[2];
-
-                    // now get density, velocity and thermal speed values
-                    n   = density(x, y, z);
-                    V   = bulkVelocity(x, y, z);
-                    Vth = thermalVelocity(x, y, z);
-
-                    // weight for all particles in this cell
-                    auto cellWeight = n * cellVolume / nbrParticlePerCell_;
-
-                    std::uniform_real_distribution<float> randPosX(0., 1.);
-                    std::uniform_real_distribution<float> randPosY(0., 1.);
-                    std::uniform_real_distribution<float> randPosZ(0., 1.);
-
-                    if (basis_ == Basis::Magnetic)
-                    {
-                        auto B = magneticField(x, y, z);
-                        localMagneticBasis(B, basis);
-                    }
-
-                    for (uint32 ipart = 0; ipart < nbrParticlePerCell_; ++ipart)
-                    {
-                        maxwellianVelocity(V, Vth, generator, particleVelocity);
-
-                        if (basis_ == Basis::Magnetic)
-                        {
-                            particleVelocity = basisTransform(basis, particleVelocity);
-                        }
-
-                        std::array<float, 3> delta
-                            = {{randPosX(generator), randPosY(generator), randPosZ(generator)}};
-
-
-                        Particle<dimension> tmpParticle;
-                        tmpParticle.weight = cellWeight;
-                        tmpParticle.charge = particleCharge_;
-                        tmpParticle.iCell  = {{static_cast<int32>(ix), static_cast<int32>(iy),
-                                              static_cast<int32>(iz)}};
-                        tmpParticle.delta  = delta;
-                        tmpParticle.v      = particleVelocity;
-
-                        particles.push_back(std::move(tmpParticle));
-                    } // end particle looop
-                }     // end z
-            }         // end y
-        }             // end x
+            function(coords[0], values);
+        }
+        else if constexpr (dimension == 2)
+        {
+            function(coords[0], coords[1], values);
+        }
+        else if constexpr (dimension == 3)
+        {
+            function(coords[0], coords[1], coords[2], values);
+        }
     }
 
 
@@ -363,6 +377,10 @@ private:
     uint32 nbrParticlePerCell_;
     Basis basis_;
     std::unique_ptr<VectorFunction<dimension>> magneticField_;
+
+    uint64 seed_;
+    std::size_t nbrThreads_;
+    ParticleCount particleCount_;
 };
 
 } // namespace PHARE
@@ -0,0 +1,124 @@
+#ifndef PHARE_CORE_DATA_IONS_PARTICLE_INITIALIZERS_MAXWELLIAN_SAMPLER_H
+#define PHARE_CORE_DATA_IONS_PARTICLE_INITIALIZERS_MAXWELLIAN_SAMPLER_H
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "utilities/random/philox.h"
+
+namespace PHARE
+{
+/** @brief MaxwellianSampler draws the velocities of blocks of up to blockSize particles
+ * from a Maxwellian distribution of given bulk and thermal velocities.
+ *
+ * Each particle uses two draws of a Philox4x32 generator, whose counters only differ from
+ * a base counter by their first word. Drawing the random bits, turning them into normal
+ * numbers with the Box-Muller transform and scaling them are done in separate loops over
+ * the whole block, on contiguous arrays, so that each of them can be vectorized. The result
+ * is the same as drawing the particles one by one with boxMuller().
+ */
+class MaxwellianSampler
+{
+public:
+    static constexpr std::size_t blockSize = 64;
+
+    //! velocities of a block of particles, component by component
+    struct VelocityBlock
+    {
+        std::array<double, blockSize> vx;
+        std::array<double, blockSize> vy;
+        std::array<double, blockSize> vz;
+    };
+
+
+    explicit MaxwellianSampler(Philox4x32 const& generator)
+        : generator_{generator}
+    {
+    }
+
+
+
+    /** @brief draw the velocities of nbrParticles <= blockSize particles
+     *
+     * The first word of the counters of the two draws of the iPart-th particle of the block
+     * is firstDraw + iPart*drawStride, plus 1 for the second draw, the other three words
+     * being those of counter.
+     */
+    void operator()(Philox4x32::counter_type counter, std::uint32_t firstDraw,
+                    std::uint32_t drawStride, std::size_t nbrParticles,
+                    std::array<double, 3> const& V, std::array<double, 3> const& Vth,
+                    VelocityBlock& velocities)
+    {
+        for (std::size_t iPart = 0; iPart < nbrParticles; ++iPart)
+        {
+            counter[0]      = firstDraw + static_cast<std::uint32_t>(iPart) * drawStride;
+            auto const bits = generator_(counter);
+
+            counter[0] += 1;
+            auto const moreBits = generator_(counter);
+
+            // Box-Muller needs its first uniform number in ]0, 1]
+            u1_[iPart] = 1. - uniformDouble(bits[0], bits[1]);
+            u2_[iPart] = uniformDouble(bits[2], bits[3]);
+            u3_[iPart] = 1. - uniformDouble(moreBits[0], moreBits[1]);
+            u4_[iPart] = uniformDouble(moreBits[2], moreBits[3]);
+        }
+
+        constexpr double twoPi = 6.283185307179586476925286766559;
+
+        for (std::size_t iPart = 0; iPart < nbrParticles; ++iPart)
+        {
+            auto const radius = std::sqrt(-2. * std::log(u1_[iPart]));
+            auto const angle  = twoPi * u2_[iPart];
+
+            velocities.vx[iPart] = V[0] + Vth[0] * (radius * std::cos(angle));
+            velocities.vy[iPart] = V[1] + Vth[1] * (radius * std::sin(angle));
+        }
+
+        for (std::size_t iPart = 0; iPart < nbrParticles; ++iPart)
+        {
+            auto const radius = std::sqrt(-2. * std::log(u3_[iPart]));
+            auto const angle  = twoPi * u4_[iPart];
+
+            velocities.vz[iPart] = V[2] + Vth[2] * (radius * std::cos(angle));
+        }
+    }
+
+
+
+    /** @brief express the velocities of the block, given in the basis, in the cartesian
+     * basis, as basisTransform() does for a single vector
+     */
+    static void rotate(std::array<std::array<double, 3>, 3> const& basis,
+                       std::size_t nbrParticles, VelocityBlock& velocities)
+    {
+        for (std::size_t iPart = 0; iPart < nbrParticles; ++iPart)
+        {
+            auto const vx = velocities.vx[iPart];
+            auto const vy = velocities.vy[iPart];
+            auto const vz = velocities.vz[iPart];
+
+            velocities.vx[iPart] = basis[0][0] * vx + basis[1][0] * vy + basis[2][0] * vz;
+            velocities.vy[iPart] = basis[0][1] * vx + basis[1][1] * vy + basis[2][1] * vz;
+            velocities.vz[iPart] = basis[0][2] * vx + basis[1][2] * vy + basis[2][2] * vz;
+        }
+    }
+
+
+
+private:
+    Philox4x32 generator_;
+
+    // uniform numbers of the block, two per draw
+    std::array<double, blockSize> u1_;
+    std::array<double, blockSize> u2_;
+    std::array<double, blockSize> u3_;
+    std::array<double, blockSize> u4_;
+};
+
+
+} // namespace PHARE
+
+#endif
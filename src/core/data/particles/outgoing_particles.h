@@ -0,0 +1,156 @@
+#ifndef PHARE_CORE_DATA_PARTICLES_OUTGOING_PARTICLES_H
+#define PHARE_CORE_DATA_PARTICLES_OUTGOING_PARTICLES_H
+
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "data/particles/packed_particle.h"
+#include "utilities/box/box.h"
+
+namespace PHARE
+{
+/** @brief OutgoingParticles collects the particles leaving a patch domain, sorted by the
+ * direction through which they leave, with their cells already in AMR index space.
+ *
+ * There is one bucket per direction (-1, 0 or +1 along each axis), 3^dim buckets in total.
+ * The direction of a particle is found by comparing its local cell to the domain box, whose
+ * lower and upper cells are included in the box. The bucket of direction {0,...,0} receives
+ * particles that are given to the OutgoingParticles although their cell is in the domain box.
+ *
+ * Buckets are std::vector<PackedParticle<dim>>, the format in which ParticlesData streams
+ * particles, so that ParticlesData::packBucketStream() streams a bucket to the neighbor patches
+ * of its direction as it is, without scanning the particles leaving through other directions.
+ *
+ * BorisPusher fills them during the push. Particles leaving through a physical boundary are
+ * only kept out of them by the move() overload that applies the BoundaryCondition.
+ */
+template<std::size_t dim>
+class OutgoingParticles
+{
+public:
+    static constexpr std::size_t nbrDirections = dim == 1 ? 3 : (dim == 2 ? 9 : 27);
+
+    using bucket_type = std::vector<PackedParticle<dim>>;
+
+
+    /**
+     * @param domainBox : box of the domain cells of the patch, in local index space
+     * @param localToAMR : vector added to local cells to get AMR cells
+     */
+    OutgoingParticles(Box<int, dim> const& domainBox, std::array<int, dim> const& localToAMR)
+        : domainBox_{domainBox}
+        , localToAMR_{localToAMR}
+    {
+    }
+
+
+
+
+    //! put the packed particle, with its cell in AMR index space, in its direction bucket
+    template<typename ParticleT>
+    void push_back(ParticleT const& particle)
+    {
+        PackedParticle<dim> outgoing{particle.weight, particle.charge, particle.iCell,
+                                     particle.delta, particle.v};
+
+        std::size_t direction = 0;
+        std::size_t stride    = 1;
+
+        for (auto iDim = 0u; iDim < dim; ++iDim)
+        {
+            auto const iCell = outgoing.iCell[iDim];
+            auto const side  = iCell < domainBox_.lower[iDim] ? 0u
+                              : (iCell > domainBox_.upper[iDim] ? 2u : 1u);
+
+            direction += side * stride;
+            stride *= 3;
+
+            outgoing.iCell[iDim] += localToAMR_[iDim];
+        }
+
+        buckets_[direction].push_back(outgoing);
+    }
+
+
+
+
+    //! bucket of the particles leaving through the given direction, made of -1, 0 and 1
+    bucket_type& bucket(std::array<int, dim> const& direction)
+    {
+        return buckets_[directionIndex_(direction)];
+    }
+
+    bucket_type const& bucket(std::array<int, dim> const& direction) const
+    {
+        return buckets_[directionIndex_(direction)];
+    }
+
+
+
+
+    //! total number of outgoing particles
+    std::size_t size() const
+    {
+        std::size_t nbrParticles = 0;
+        for (auto const& bucket : buckets_)
+        {
+            nbrParticles += bucket.size();
+        }
+        return nbrParticles;
+    }
+
+
+    void clear()
+    {
+        for (auto& bucket : buckets_)
+        {
+            bucket.clear();
+        }
+    }
+
+
+    //! add the particles of other, which must have the same domain box, to our buckets
+    void append(OutgoingParticles const& other)
+    {
+        for (std::size_t iDirection = 0; iDirection < nbrDirections; ++iDirection)
+        {
+            auto const& otherBucket = other.buckets_[iDirection];
+            buckets_[iDirection].insert(std::end(buckets_[iDirection]), std::begin(otherBucket),
+                                        std::end(otherBucket));
+        }
+    }
+
+
+    //! an OutgoingParticles with the same domain box and shift, and empty buckets
+    OutgoingParticles emptyCopy() const { return OutgoingParticles{domainBox_, localToAMR_}; }
+
+
+
+
+private:
+    Box<int, dim> domainBox_;
+    std::array<int, dim> localToAMR_;
+    std::array<bucket_type, nbrDirections> buckets_;
+
+
+    static std::size_t directionIndex_(std::array<int, dim> const& direction)
+    {
+        std::size_t index  = 0;
+        std::size_t stride = 1;
+        for (auto iDim = 0u; iDim < dim; ++iDim)
+        {
+            index += static_cast<std::size_t>(direction[iDim] + 1) * stride;
+            stride *= 3;
+        }
+        return index;
+    }
+};
+
+
+
+} // namespace PHARE
+
+
+#endif
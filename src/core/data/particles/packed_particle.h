@@ -0,0 +1,59 @@
+#ifndef PHARE_CORE_DATA_PARTICLES_PACKED_PARTICLE_H
+#define PHARE_CORE_DATA_PARTICLES_PACKED_PARTICLE_H
+
+#include <array>
+#include <cstddef>
+
+#include "data/particles/particle.h"
+
+namespace PHARE
+{
+/** @brief PackedParticle is the format in which ParticlesData streams particles.
+ *
+ * It only holds what defines a particle: weight, charge, iCell, delta and velocity. The
+ * electromagnetic fields stored on Particle are interpolated again by the receiver, so they
+ * are not sent, which makes a streamed particle about half the size of a Particle.
+ *
+ * OutgoingParticles stores leaving particles in this format, so that ParticlesData can stream
+ * its buckets without converting them.
+ *
+ * Members are ordered so that the struct has no padding whatever the dimension.
+ */
+template<std::size_t dim>
+struct PackedParticle
+{
+    double weight;
+    double charge;
+    std::array<int, dim> iCell;
+    std::array<float, dim> delta;
+    std::array<double, 3> v;
+};
+
+
+
+template<std::size_t dim>
+PackedParticle<dim> toPackedParticle(Particle<dim> const& particle)
+{
+    return {particle.weight, particle.charge, particle.iCell, particle.delta, particle.v};
+}
+
+
+
+//! the particle described by a PackedParticle, with null electromagnetic fields
+template<std::size_t dim>
+Particle<dim> fromPackedParticle(PackedParticle<dim> const& packed)
+{
+    Particle<dim> particle;
+    particle.weight = packed.weight;
+    particle.charge = packed.charge;
+    particle.iCell  = packed.iCell;
+    particle.delta  = packed.delta;
+    particle.v      = packed.v;
+    return particle;
+}
+
+
+
+} // namespace PHARE
+
+#endif
@@ -35,7 +35,7 @@ struct Particle<1>
 };
 
 
-const std::size_t Particle<1>::dimension = 1;
+inline const std::size_t Particle<1>::dimension = 1;
 
 
 
@@ -55,7 +55,7 @@ struct Particle<2>
     static const std::size_t dimension;
 };
 
-const std::size_t Particle<2>::dimension = 2;
+inline const std::size_t Particle<2>::dimension = 2;
 
 
 template<>
@@ -75,7 +75,7 @@ struct Particle<3>
 };
 
 
-const std::size_t Particle<3>::dimension = 3;
+inline const std::size_t Particle<3>::dimension = 3;
 
 
 
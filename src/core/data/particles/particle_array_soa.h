@@ -0,0 +1,370 @@
+#ifndef PHARE_CORE_DATA_PARTICLES_PARTICLE_ARRAY_SOA_H
+#define PHARE_CORE_DATA_PARTICLES_PARTICLE_ARRAY_SOA_H
+
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "particle.h"
+
+namespace PHARE
+{
+/** @brief ParticleProxy is what one gets when dereferencing an iterator on a ParticleArraySoA
+ *
+ * It has the same members as a Particle<dim>, but they are references to the elements of
+ * the arrays stored in the ParticleArraySoA. Code written for a Particle<dim> (pusher,
+ * interpolator, moments, selectors) can thus be used with a ParticleArraySoA. A proxy holds
+ * a reference to every array, so such code only avoids loading the arrays it does not use
+ * once the proxy is inlined away. Kernels that must stream a single attribute use the
+ * attribute arrays of the ParticleArraySoA instead.
+ *
+ * Assigning a proxy to another copies the values, not the references, like assigning
+ * a Particle<dim> to another would. Converting a proxy to a Particle<dim> makes a copy.
+ */
+template<std::size_t dim, bool isConst>
+struct ParticleProxy
+{
+    template<typename T>
+    using ref_type = std::conditional_t<isConst, T const&, T&>;
+
+    ref_type<double> weight;
+    ref_type<double> charge;
+
+    ref_type<std::array<int, dim>> iCell;
+    ref_type<std::array<float, dim>> delta;
+    ref_type<std::array<double, 3>> v;
+
+    ref_type<double> Ex, Ey, Ez;
+    ref_type<double> Bx, By, Bz;
+
+    static constexpr std::size_t dimension = dim;
+
+
+    operator Particle<dim>() const
+    {
+        return {weight, charge, iCell, delta, v, Ex, Ey, Ez, Bx, By, Bz};
+    }
+
+
+    ParticleProxy& operator=(Particle<dim> const& particle)
+    {
+        assign_(particle);
+        return *this;
+    }
+
+
+    ParticleProxy& operator=(ParticleProxy const& proxy)
+    {
+        assign_(proxy);
+        return *this;
+    }
+
+
+    template<bool isOtherConst>
+    ParticleProxy& operator=(ParticleProxy<dim, isOtherConst> const& proxy)
+    {
+        assign_(proxy);
+        return *this;
+    }
+
+
+    //! swaps the values referenced by two proxies, used by std::swap-based algorithms
+    friend void swap(ParticleProxy a, ParticleProxy b)
+    {
+        Particle<dim> tmp = a;
+        a                 = b;
+        b                 = tmp;
+    }
+
+
+private:
+    template<typename ParticleLike>
+    void assign_(ParticleLike const& particle)
+    {
+        weight = particle.weight;
+        charge = particle.charge;
+        iCell  = particle.iCell;
+        delta  = particle.delta;
+        v      = particle.v;
+        Ex     = particle.Ex;
+        Ey     = particle.Ey;
+        Ez     = particle.Ez;
+        Bx     = particle.Bx;
+        By     = particle.By;
+        Bz     = particle.Bz;
+    }
+};
+
+
+
+
+/** @brief ParticleArraySoA is a structure-of-arrays particle container
+ *
+ * ParticleArray<dim> stores particles as an array of Particle<dim> structures, which means
+ * any loop touching only the positions or the velocities still strides over whole particles.
+ * ParticleArraySoA stores each particle attribute in its own contiguous array. It can be
+ * used in place of ParticleArray<dim> (as the ParticleArray of IonPopulation and
+ * ParticlesPack, or the ParticleArrayT of ParticlesData) since it exposes the subset of the
+ * std::vector interface used on particle arrays, and its iterators are random access
+ * iterators whose reference type is a ParticleProxy.
+ */
+template<std::size_t dim>
+class ParticleArraySoA
+{
+public:
+    static constexpr std::size_t dimension = dim;
+
+    using value_type      = Particle<dim>;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = ParticleProxy<dim, false>;
+    using const_reference = ParticleProxy<dim, true>;
+
+
+    template<bool isConst>
+    class iterator_t
+    {
+    public:
+        using array_type = std::conditional_t<isConst, ParticleArraySoA const, ParticleArraySoA>;
+
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = Particle<dim>;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = ParticleProxy<dim, isConst>;
+
+        //! operator-> cannot return the address of a temporary proxy, so it returns
+        //! this wrapper holding the proxy by value.
+        struct pointer
+        {
+            reference proxy;
+            reference* operator->() { return &proxy; }
+        };
+
+
+        iterator_t() = default;
+
+        iterator_t(array_type* array, std::size_t index)
+            : array_{array}
+            , index_{index}
+        {
+        }
+
+        operator iterator_t<true>() const { return {array_, index_}; }
+
+
+        reference operator*() const { return array_->proxy_(index_); }
+        pointer operator->() const { return pointer{**this}; }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+
+        iterator_t& operator++()
+        {
+            ++index_;
+            return *this;
+        }
+        iterator_t operator++(int)
+        {
+            auto copy = *this;
+            ++index_;
+            return copy;
+        }
+        iterator_t& operator--()
+        {
+            --index_;
+            return *this;
+        }
+        iterator_t operator--(int)
+        {
+            auto copy = *this;
+            --index_;
+            return copy;
+        }
+
+        iterator_t& operator+=(difference_type n)
+        {
+            index_ += n;
+            return *this;
+        }
+        iterator_t& operator-=(difference_type n)
+        {
+            index_ -= n;
+            return *this;
+        }
+
+        friend iterator_t operator+(iterator_t it, difference_type n) { return it += n; }
+        friend iterator_t operator+(difference_type n, iterator_t it) { return it += n; }
+        friend iterator_t operator-(iterator_t it, difference_type n) { return it -= n; }
+
+        friend difference_type operator-(iterator_t const& a, iterator_t const& b)
+        {
+            return static_cast<difference_type>(a.index_) - static_cast<difference_type>(b.index_);
+        }
+
+        friend bool operator==(iterator_t const& a, iterator_t const& b)
+        {
+            return a.index_ == b.index_ && a.array_ == b.array_;
+        }
+        friend bool operator!=(iterator_t const& a, iterator_t const& b) { return !(a == b); }
+        friend bool operator<(iterator_t const& a, iterator_t const& b)
+        {
+            return a.index_ < b.index_;
+        }
+        friend bool operator>(iterator_t const& a, iterator_t const& b) { return b < a; }
+        friend bool operator<=(iterator_t const& a, iterator_t const& b) { return !(b < a); }
+        friend bool operator>=(iterator_t const& a, iterator_t const& b) { return !(a < b); }
+
+
+        std::size_t index() const { return index_; }
+
+    private:
+        array_type* array_{nullptr};
+        std::size_t index_{0};
+    };
+
+    using iterator       = iterator_t<false>;
+    using const_iterator = iterator_t<true>;
+
+
+
+
+    ParticleArraySoA() = default;
+
+    explicit ParticleArraySoA(std::size_t size) { resize(size); }
+
+
+
+    std::size_t size() const { return weight_.size(); }
+    bool empty() const { return weight_.empty(); }
+    std::size_t capacity() const { return weight_.capacity(); }
+
+
+    void reserve(std::size_t size)
+    {
+        forEachArray_([size](auto& array) { array.reserve(size); });
+    }
+
+    void resize(std::size_t size)
+    {
+        forEachArray_([size](auto& array) { array.resize(size); });
+    }
+
+    void clear()
+    {
+        forEachArray_([](auto& array) { array.clear(); });
+    }
+
+
+    void push_back(Particle<dim> const& particle)
+    {
+        weight_.push_back(particle.weight);
+        charge_.push_back(particle.charge);
+        iCell_.push_back(particle.iCell);
+        delta_.push_back(particle.delta);
+        v_.push_back(particle.v);
+        Ex_.push_back(particle.Ex);
+        Ey_.push_back(particle.Ey);
+        Ez_.push_back(particle.Ez);
+        Bx_.push_back(particle.Bx);
+        By_.push_back(particle.By);
+        Bz_.push_back(particle.Bz);
+    }
+
+
+    reference operator[](std::size_t i) { return proxy_(i); }
+    const_reference operator[](std::size_t i) const { return proxy_(i); }
+
+    reference back() { return proxy_(size() - 1); }
+    const_reference back() const { return proxy_(size() - 1); }
+
+
+    iterator begin() { return {this, 0}; }
+    iterator end() { return {this, size()}; }
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, size()}; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+
+    /** erase the particles in [first, last[. This is cheap when erasing the tail of the array,
+     * which is what is done with particles leaving a patch.
+     */
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        auto const nbrErased = static_cast<std::size_t>(last - first);
+        auto const firstIdx  = first.index();
+        auto const newSize   = size() - nbrErased;
+
+        for (std::size_t i = firstIdx; i < newSize; ++i)
+        {
+            proxy_(i) = proxy_(i + nbrErased);
+        }
+        resize(newSize);
+        return {this, firstIdx};
+    }
+
+
+    // direct access to the attribute arrays, for kernels that want to stream
+    // over a single attribute
+    std::vector<double>& weight() { return weight_; }
+    std::vector<double>& charge() { return charge_; }
+    std::vector<std::array<int, dim>>& iCell() { return iCell_; }
+    std::vector<std::array<float, dim>>& delta() { return delta_; }
+    std::vector<std::array<double, 3>>& v() { return v_; }
+
+    std::vector<double> const& weight() const { return weight_; }
+    std::vector<double> const& charge() const { return charge_; }
+    std::vector<std::array<int, dim>> const& iCell() const { return iCell_; }
+    std::vector<std::array<float, dim>> const& delta() const { return delta_; }
+    std::vector<std::array<double, 3>> const& v() const { return v_; }
+
+
+
+private:
+    std::vector<double> weight_;
+    std::vector<double> charge_;
+    std::vector<std::array<int, dim>> iCell_;
+    std::vector<std::array<float, dim>> delta_;
+    std::vector<std::array<double, 3>> v_;
+    std::vector<double> Ex_, Ey_, Ez_;
+    std::vector<double> Bx_, By_, Bz_;
+
+
+    reference proxy_(std::size_t i)
+    {
+        return {weight_[i], charge_[i], iCell_[i], delta_[i], v_[i], Ex_[i],
+                Ey_[i],     Ez_[i],     Bx_[i],    By_[i],    Bz_[i]};
+    }
+
+    const_reference proxy_(std::size_t i) const
+    {
+        return {weight_[i], charge_[i], iCell_[i], delta_[i], v_[i], Ex_[i],
+                Ey_[i],     Ez_[i],     Bx_[i],    By_[i],    Bz_[i]};
+    }
+
+
+    template<typename Fn>
+    void forEachArray_(Fn&& fn)
+    {
+        fn(weight_);
+        fn(charge_);
+        fn(iCell_);
+        fn(delta_);
+        fn(v_);
+        fn(Ex_);
+        fn(Ey_);
+        fn(Ez_);
+        fn(Bx_);
+        fn(By_);
+        fn(Bz_);
+    }
+};
+
+
+
+} // namespace PHARE
+
+
+#endif
@@ -0,0 +1,194 @@
+#ifndef PHARE_CORE_DATA_PARTICLES_PARTICLE_CELL_INDEX_H
+#define PHARE_CORE_DATA_PARTICLES_PARTICLE_CELL_INDEX_H
+
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "utilities/box/box.h"
+
+namespace PHARE
+{
+/** @brief CellIndex sorts a particle array by cell and keeps the offset of the first particle
+ * of each cell of a box in the sorted array, i.e. the prefix sum of the number of particles
+ * per cell.
+ *
+ * Cells are ordered with the first direction varying fastest, so that the particles of a row
+ * of cells along the first direction are contiguous in the array. Selecting the particles of
+ * a box then costs one lookup per row of the box instead of a scan of the whole array.
+ *
+ * The lower and upper cells of the boxes given to a CellIndex are included in the boxes.
+ * Particles found outside of the box of the index, if any, are put after all the others.
+ */
+template<std::size_t dim>
+class CellIndex
+{
+public:
+    CellIndex() = default;
+
+    explicit CellIndex(Box<int, dim> const& box)
+        : box_{box}
+    {
+        std::size_t nbrCells = 1;
+        for (auto iDim = 0u; iDim < dim; ++iDim)
+        {
+            shape_[iDim] = std::max(0, box_.upper[iDim] - box_.lower[iDim] + 1);
+            nbrCells *= static_cast<std::size_t>(shape_[iDim]);
+        }
+        offsets_.assign(nbrCells + 1, 0);
+    }
+
+
+
+
+    /** sort the particles by cell with a counting sort and build the offset table.
+     * The index then describes this array until its particles are moved or added.
+     */
+    template<typename ParticleArrayT>
+    void sort(ParticleArrayT& particles)
+    {
+        auto const nbrCells = offsets_.size() - 1;
+        size_               = particles.size();
+
+        std::vector<std::size_t> keys(size_);
+        std::vector<std::size_t> nbrParticlesPerCell(nbrCells + 1, 0);
+
+        for (std::size_t iPart = 0; iPart < size_; ++iPart)
+        {
+            keys[iPart] = key_(particles[iPart].iCell);
+            ++nbrParticlesPerCell[keys[iPart]];
+        }
+
+        std::vector<std::size_t> nextPosition(nbrCells + 1, 0);
+        for (std::size_t iCell = 0; iCell < nbrCells; ++iCell)
+        {
+            offsets_[iCell + 1]     = offsets_[iCell] + nbrParticlesPerCell[iCell];
+            nextPosition[iCell + 1] = offsets_[iCell + 1];
+        }
+
+        ParticleArrayT sorted(size_);
+        for (std::size_t iPart = 0; iPart < size_; ++iPart)
+        {
+            sorted[nextPosition[keys[iPart]]++] = particles[iPart];
+        }
+        particles = std::move(sorted);
+    }
+
+
+
+
+    //! number of particles in the array the index was built for
+    std::size_t size() const { return size_; }
+
+
+
+
+    /** call fn(first, last) for each range [first, last[ of particles of the sorted array
+     * whose cells are in the given box. Particles outside the box of the index are not
+     * visited, see outsideRange().
+     */
+    template<typename Fn>
+    void forEachRangeIn(Box<int, dim> const& box, Fn&& fn) const
+    {
+        std::array<int, dim> lower;
+        std::array<int, dim> upper;
+
+        for (auto iDim = 0u; iDim < dim; ++iDim)
+        {
+            lower[iDim] = std::max(box.lower[iDim], box_.lower[iDim]);
+            upper[iDim] = std::min(box.upper[iDim], box_.upper[iDim]);
+            if (lower[iDim] > upper[iDim])
+            {
+                return;
+            }
+        }
+
+        auto cell = lower;
+        while (true)
+        {
+            auto rowEnd = cell;
+            rowEnd[0]   = upper[0];
+
+            auto const first = offsets_[key_(cell)];
+            auto const last  = offsets_[key_(rowEnd) + 1];
+            if (first != last)
+            {
+                fn(first, last);
+            }
+
+            // go to the next row of the box
+            auto iDim = 1u;
+            for (; iDim < dim; ++iDim)
+            {
+                if (++cell[iDim] <= upper[iDim])
+                {
+                    break;
+                }
+                cell[iDim] = lower[iDim];
+            }
+            if (iDim >= dim)
+            {
+                return;
+            }
+        }
+    }
+
+
+
+
+    //! number of particles whose cells are in the given box
+    std::size_t count(Box<int, dim> const& box) const
+    {
+        std::size_t nbrParticles = 0;
+        forEachRangeIn(box, [&nbrParticles](std::size_t first, std::size_t last) {
+            nbrParticles += last - first;
+        });
+        return nbrParticles;
+    }
+
+
+
+
+    //! range [first, last[ of the particles that were outside the box of the index
+    std::pair<std::size_t, std::size_t> outsideRange() const { return {offsets_.back(), size_}; }
+
+
+
+
+private:
+    Box<int, dim> box_;
+    std::array<int, dim> shape_{};
+    std::vector<std::size_t> offsets_{0};
+    std::size_t size_{0};
+
+
+    //! linear index of a cell, or the number of cells if it is outside the box
+    template<typename Cell>
+    std::size_t key_(Cell const& iCell) const
+    {
+        std::size_t key    = 0;
+        std::size_t stride = 1;
+
+        for (auto iDim = 0u; iDim < dim; ++iDim)
+        {
+            auto const local = iCell[iDim] - box_.lower[iDim];
+            if (local < 0 || local >= shape_[iDim])
+            {
+                return offsets_.size() - 1;
+            }
+            key += static_cast<std::size_t>(local) * stride;
+            stride *= static_cast<std::size_t>(shape_[iDim]);
+        }
+        return key;
+    }
+};
+
+
+
+} // namespace PHARE
+
+
+#endif
@@ -0,0 +1,291 @@
+#ifndef PHARE_CORE_DATA_PARTICLES_PARTICLE_SORT_H
+#define PHARE_CORE_DATA_PARTICLES_PARTICLE_SORT_H
+
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "utilities/parallel/parallel_for.h"
+
+namespace PHARE
+{
+/** @brief spread the lowest bits of x so that there are dim - 1 zero bits between two bits
+ * of x. Interleaving spread coordinates gives their Morton (Z-order) code.
+ */
+template<std::size_t dim>
+constexpr std::uint64_t spreadBits(std::uint64_t x)
+{
+    if constexpr (dim == 1)
+    {
+        return x;
+    }
+    else if constexpr (dim == 2)
+    {
+        x &= 0x00000000ffffffff;
+        x = (x | (x << 16)) & 0x0000ffff0000ffff;
+        x = (x | (x << 8)) & 0x00ff00ff00ff00ff;
+        x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0f;
+        x = (x | (x << 2)) & 0x3333333333333333;
+        x = (x | (x << 1)) & 0x5555555555555555;
+        return x;
+    }
+    else
+    {
+        x &= 0x00000000001fffff;
+        x = (x | (x << 32)) & 0x001f00000000ffff;
+        x = (x | (x << 16)) & 0x001f0000ff0000ff;
+        x = (x | (x << 8)) & 0x100f00f00f00f00f;
+        x = (x | (x << 4)) & 0x10c30c30c30c30c3;
+        x = (x | (x << 2)) & 0x1249249249249249;
+        return x;
+    }
+}
+
+
+
+
+/** @brief mortonKey returns the position of a cell along the Morton space filling curve.
+ * Cells are taken relative to origin, which must be lower or equal to all cells sorted,
+ * and the first direction gets the lowest bit.
+ */
+template<std::size_t dim, typename Cell>
+std::uint64_t mortonKey(Cell const& iCell, std::array<int, dim> const& origin)
+{
+    std::uint64_t key = 0;
+    for (auto iDim = 0u; iDim < dim; ++iDim)
+    {
+        auto const local = static_cast<std::uint64_t>(static_cast<std::int64_t>(iCell[iDim])
+                                                      - static_cast<std::int64_t>(origin[iDim]));
+        key |= spreadBits<dim>(local) << iDim;
+    }
+    return key;
+}
+
+
+
+
+//! lowest cell index of the particles in each direction
+template<typename ParticleArrayT, std::size_t dim = ParticleArrayT::value_type::dimension>
+std::array<int, dim> lowestCell(ParticleArrayT const& particles)
+{
+    std::array<int, dim> lowest;
+    lowest.fill(std::numeric_limits<int>::max());
+
+    for (auto const& particle : particles)
+    {
+        for (auto iDim = 0u; iDim < dim; ++iDim)
+        {
+            lowest[iDim] = std::min(lowest[iDim], particle.iCell[iDim]);
+        }
+    }
+    return lowest;
+}
+
+
+
+
+/** @brief mortonDisorder measures how far particles are from the Morton order of their cells.
+ *
+ * It returns the fraction of consecutive pairs of particles whose Morton keys decrease:
+ * 0 for sorted particles, about 0.5 for randomly ordered ones.
+ */
+template<typename ParticleArrayT, std::size_t dim = ParticleArrayT::value_type::dimension>
+double mortonDisorder(ParticleArrayT const& particles)
+{
+    if (particles.size() < 2)
+    {
+        return 0.;
+    }
+
+    auto const origin = lowestCell(particles);
+
+    std::size_t nbrDecreasing = 0;
+    auto previousKey          = mortonKey<dim>(particles[0].iCell, origin);
+
+    for (std::size_t iPart = 1; iPart < particles.size(); ++iPart)
+    {
+        auto const key = mortonKey<dim>(particles[iPart].iCell, origin);
+        if (key < previousKey)
+        {
+            ++nbrDecreasing;
+        }
+        previousKey = key;
+    }
+
+    return static_cast<double>(nbrDecreasing) / static_cast<double>(particles.size() - 1);
+}
+
+
+
+
+/** @brief radixSortByKey sorts keys, and values alongside, with a least significant digit
+ * radix sort on 8-bit digits. Only the digits needed by the largest key are sorted.
+ *
+ * Each pass splits the arrays in nbrThreads chunks: chunks count their digits concurrently,
+ * and then scatter their elements concurrently at offsets given by the prefix sum of these
+ * counts. The sort is stable, so the result does not depend on the number of threads.
+ */
+template<typename Value>
+void radixSortByKey(std::vector<std::uint64_t>& keys, std::vector<Value>& values,
+                    std::size_t nbrThreads = 1)
+{
+    constexpr std::size_t radixBits = 8;
+    constexpr std::size_t radix     = std::size_t{1} << radixBits;
+
+    auto const size      = keys.size();
+    auto const nbrChunks = std::max(std::size_t{1}, std::min(nbrThreads, size));
+
+    auto const maxKey = size == 0 ? 0 : *std::max_element(std::begin(keys), std::end(keys));
+
+    std::vector<std::uint64_t> sortedKeys(size);
+    std::vector<Value> sortedValues(size);
+    std::vector<std::array<std::size_t, radix>> offsets(nbrChunks);
+
+    for (std::size_t shift = 0; shift < 64 && (maxKey >> shift) != 0; shift += radixBits)
+    {
+        auto digit = [shift](std::uint64_t key) { return (key >> shift) & (radix - 1); };
+
+        parallelForChunks(size, nbrChunks,
+                          [&](std::size_t first, std::size_t last, std::size_t iChunk) {
+                              auto& count = offsets[iChunk];
+                              count.fill(0);
+                              for (auto i = first; i < last; ++i)
+                              {
+                                  ++count[digit(keys[i])];
+                              }
+                          });
+
+        // elements of digit d of chunk c go after those of lower digits,
+        // and after those of digit d of the previous chunks
+        std::size_t offset = 0;
+        for (std::size_t d = 0; d < radix; ++d)
+        {
+            for (auto& count : offsets)
+            {
+                auto const nbrInChunk = count[d];
+                count[d]              = offset;
+                offset += nbrInChunk;
+            }
+        }
+
+        parallelForChunks(size, nbrChunks,
+                          [&](std::size_t first, std::size_t last, std::size_t iChunk) {
+                              auto& next = offsets[iChunk];
+                              for (auto i = first; i < last; ++i)
+                              {
+                                  auto const position    = next[digit(keys[i])]++;
+                                  sortedKeys[position]   = keys[i];
+                                  sortedValues[position] = values[i];
+                              }
+                          });
+
+        std::swap(keys, sortedKeys);
+        std::swap(values, sortedValues);
+    }
+}
+
+
+
+
+/** @brief sortByMortonOrder sorts particles along the Morton curve of their cells, so that
+ * particles close in the array are close on the grid and the field values they interpolate
+ * are close in memory.
+ *
+ * Keys are computed relative to the lowest cell of the particles and sorted with
+ * radixSortByKey(), then particles are moved to their new positions. All steps use
+ * nbrThreads threads.
+ */
+template<typename ParticleArrayT, std::size_t dim = ParticleArrayT::value_type::dimension>
+void sortByMortonOrder(ParticleArrayT& particles, std::size_t nbrThreads = 1)
+{
+    auto const size = particles.size();
+    if (size < 2)
+    {
+        return;
+    }
+
+    auto const origin    = lowestCell(particles);
+    auto const nbrChunks = std::max(std::size_t{1}, std::min(nbrThreads, size));
+
+    std::vector<std::uint64_t> keys(size);
+    std::vector<std::size_t> indexes(size);
+
+    parallelForChunks(size, nbrChunks, [&](std::size_t first, std::size_t last, std::size_t) {
+        for (auto i = first; i < last; ++i)
+        {
+            keys[i]    = mortonKey<dim>(particles[i].iCell, origin);
+            indexes[i] = i;
+        }
+    });
+
+    radixSortByKey(keys, indexes, nbrThreads);
+
+    ParticleArrayT sorted(size);
+    parallelForChunks(size, nbrChunks, [&](std::size_t first, std::size_t last, std::size_t) {
+        for (auto i = first; i < last; ++i)
+        {
+            sorted[i] = particles[indexes[i]];
+        }
+    });
+    particles = std::move(sorted);
+}
+
+
+
+
+/** @brief MortonSortPolicy decides when particles are sorted again along the Morton curve.
+ *
+ * sortIfNeeded() is meant to be called once per time step. It sorts the particles every
+ * sortPeriod calls, or as soon as their mortonDisorder() is above disorderThreshold.
+ * A sortPeriod of 0 disables periodic sorting, a disorderThreshold of 1 or more disables
+ * the disorder check, which then costs nothing.
+ */
+class MortonSortPolicy
+{
+public:
+    MortonSortPolicy(std::size_t sortPeriod, double disorderThreshold = 1.,
+                     std::size_t nbrThreads = 1)
+        : sortPeriod_{sortPeriod}
+        , disorderThreshold_{disorderThreshold}
+        , nbrThreads_{nbrThreads}
+    {
+    }
+
+
+    //! @return true if the particles have been sorted
+    template<typename ParticleArrayT>
+    bool sortIfNeeded(ParticleArrayT& particles)
+    {
+        ++nbrCalls_;
+
+        bool const periodReached = sortPeriod_ > 0 && nbrCalls_ % sortPeriod_ == 0;
+        bool const tooDisordered = !periodReached && disorderThreshold_ < 1.
+                                   && mortonDisorder(particles) > disorderThreshold_;
+
+        if (periodReached || tooDisordered)
+        {
+            sortByMortonOrder(particles, nbrThreads_);
+            return true;
+        }
+        return false;
+    }
+
+
+private:
+    std::size_t sortPeriod_;
+    double disorderThreshold_;
+    std::size_t nbrThreads_;
+    std::size_t nbrCalls_{0};
+};
+
+
+
+} // namespace PHARE
+
+
+#endif
@@ -82,6 +82,33 @@ public:
         }
     }
 
+
+
+    //! the component pointer setBuffer() sets for bufferName, to be set directly
+    field_type*& getFieldBuffer(std::string const& bufferName)
+    {
+        if (bufferName == componentNames_[0])
+        {
+            return xComponent_;
+        }
+        else if (bufferName == componentNames_[1])
+        {
+            return yComponent_;
+        }
+        else if (bufferName == componentNames_[2])
+        {
+            return zComponent_;
+        }
+        throw std::runtime_error("Error - invalid VecField buffer name");
+    }
+
+
+
+    //! index of the handles the ResourcesManager bound this VecField to, -1 if none
+    int getResourcesHandle() const { return resourcesHandle_; }
+
+    void setResourcesHandle(int handle) { resourcesHandle_ = handle; }
+
     //! return true if the VecField can be used to access component data
     bool isUsable() const
     {
@@ -145,6 +172,7 @@ private:
     field_type* xComponent_ = nullptr;
     field_type* yComponent_ = nullptr;
     field_type* zComponent_ = nullptr;
+    int resourcesHandle_    = -1;
 };
 
 } // namespace PHARE
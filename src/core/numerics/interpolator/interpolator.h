@@ -3,6 +3,7 @@
 
 #include <array>
 #include <cstddef>
+#include <iterator>
 
 #include "data/grid/gridlayout.h"
 #include "data/vecfield/vecfield_component.h"
@@ -26,6 +27,18 @@ int computeStartIndex(double normalizedPos)
 
 
 
+/**
+ * @brief dualOffset returns the offset by which changing the
+ * startIndex for dual node interpolation. This offset depends on
+ * interpolation order. */
+inline constexpr double dualOffset(int order)
+{
+    std::array<double, 3> offsets = {{-0.5, -0.5, 0.5}};
+    return offsets[static_cast<std::array<double, 3>::size_type>(order - 1)];
+}
+
+
+
 
 /** \brief the class Weight aims at computing the weight coefficient for
  *  interpolation at a specific order
@@ -251,6 +264,31 @@ public:
 
 
 
+//! electromagnetic field components interpolated at a particle position
+struct EMFieldsAtParticle
+{
+    double Ex, Ey, Ez;
+    double Bx, By, Bz;
+};
+
+
+
+/** \brief ShapeCachePolicy tells whether caching the shape factors of particles pays off at
+ * a given interpolation order.
+ *
+ * A cached particle costs 2*dim*(4 + 8*(order+1)) bytes. At order 1 the weights are a
+ * subtraction away from the position, so reading them back from memory is not faster than
+ * computing them again, and the cache is not used. Orders 2 and 3 need a dozen or more
+ * operations per direction and centering, which the cache saves.
+ */
+template<std::size_t interpOrder>
+struct ShapeCachePolicy
+{
+    static constexpr bool enabled = interpOrder >= 2;
+};
+
+
+
 /** \brief Interpolator is used to perform particle-mesh interpolations using
  * 1st, 2nd or 3rd order interpolation in 1D, 2D or 3D, on a given layout.
  */
@@ -258,6 +296,10 @@ template<typename GridLayout>
 class Interpolator : private Weighter<GridLayout::interp_order>
 {
 public:
+    static constexpr std::size_t dimension    = GridLayout::dimension;
+    static constexpr std::size_t interp_order = GridLayout::interp_order;
+
+
     /**\brief interpolate electromagnetic fields on all particles in the range
      *
      * For each particle :
@@ -269,39 +311,41 @@ public:
     template<typename PartIterator, typename Electromag>
     inline void operator()(PartIterator begin, PartIterator end, Electromag const& Em)
     {
-        // this lambda calculates the startIndex and the order+1 weights for
-        // dual field interpolation and puts this at the corresponding location
-        // in 'startIndex' and 'weights'. For dual fields, the normalizedPosition
-        // is offseted compared to primal ones.
-        auto indexAndWeightDual = [this](auto const& part) {
-            for (auto iDim = 0u; iDim < GridLayout::dimension; ++iDim)
-            {
-                double normalizedPos
-                    = part.iCell[iDim] + part.delta[iDim] + dualOffset(GridLayout::interp_order);
-
-                startIndex[centering2int(QtyCentering::dual)][iDim]
-                    = computeStartIndex<GridLayout::interp_order>(normalizedPos);
+        auto const& Ex = Em.E.getComponent(Component::X);
+        auto const& Ey = Em.E.getComponent(Component::Y);
+        auto const& Ez = Em.E.getComponent(Component::Z);
+        auto const& Bx = Em.B.getComponent(Component::X);
+        auto const& By = Em.B.getComponent(Component::Y);
+        auto const& Bz = Em.B.getComponent(Component::Z);
 
-                weightComputer_.computeWeight(normalizedPos,
-                                              startIndex[centering2int(QtyCentering::dual)][iDim],
-                                              weights[centering2int(QtyCentering::dual)][iDim]);
-            }
-        };
+        for (auto currPart = begin; currPart != end; ++currPart)
+        {
+            auto const fields = interpolate_(*currPart, Ex, Ey, Ez, Bx, By, Bz);
+
+            currPart->Ex = fields.Ex;
+            currPart->Ey = fields.Ey;
+            currPart->Ez = fields.Ez;
+            currPart->Bx = fields.Bx;
+            currPart->By = fields.By;
+            currPart->Bz = fields.Bz;
+        }
+    }
 
-        // does the same as above but for a primal field
-        auto indexAndWeightPrimal = [this](auto const& part) {
-            for (auto iDim = 0u; iDim < GridLayout::dimension; ++iDim)
-            {
-                double normalizedPos = part.iCell[iDim] + part.delta[iDim];
 
-                startIndex[centering2int(QtyCentering::primal)][iDim]
-                    = computeStartIndex<GridLayout::interp_order>(normalizedPos);
 
-                weightComputer_.computeWeight(normalizedPos,
-                                              startIndex[centering2int(QtyCentering::primal)][iDim],
-                                              weights[centering2int(QtyCentering::primal)][iDim]);
-            }
-        };
+    /**\brief interpolate electromagnetic fields on all particles in the range, reading the
+     * start indexes and weights of the particles from a ShapeCache
+     *
+     * The cache must have been updated with the same range, and positions must not have been
+     * changed since. Throws if the cache and the range do not have the same size. Only
+     * available at the orders for which ShapeCachePolicy is enabled.
+     */
+    template<typename PartIterator, typename Electromag, typename ShapeCache>
+    inline void operator()(PartIterator begin, PartIterator end, Electromag const& Em,
+                           ShapeCache const& shapes)
+    {
+        static_assert(ShapeCachePolicy<interp_order>::enabled,
+                      "shapes are not cached at this interpolation order");
 
         auto const& Ex = Em.E.getComponent(Component::X);
         auto const& Ey = Em.E.getComponent(Component::Y);
@@ -310,35 +354,41 @@ public:
         auto const& By = Em.B.getComponent(Component::Y);
         auto const& Bz = Em.B.getComponent(Component::Z);
 
-        auto const ExCentering = GridLayout::centering(HybridQuantity::Scalar::Ex);
-        auto const EyCentering = GridLayout::centering(HybridQuantity::Scalar::Ey);
-        auto const EzCentering = GridLayout::centering(HybridQuantity::Scalar::Ez);
-        auto const BxCentering = GridLayout::centering(HybridQuantity::Scalar::Bx);
-        auto const ByCentering = GridLayout::centering(HybridQuantity::Scalar::By);
-        auto const BzCentering = GridLayout::centering(HybridQuantity::Scalar::Bz);
+        shapes.checkSize(static_cast<std::size_t>(std::distance(begin, end)));
 
-
-        // for each particle, first calculate the startIndex and weights
-        // for dual and primal quantities.
-        // then, knowing the centering (primal or dual) of each electromagnetic
-        // component, we use Interpol to actually perform the interpolation.
-        // the trick here is that the StartIndex and weights have only been calculated
-        // twice, and not for each E,B component.
-        for (auto currPart = begin; currPart != end; ++currPart)
+        std::size_t iPart = 0;
+        for (auto currPart = begin; currPart != end; ++currPart, ++iPart)
         {
-            indexAndWeightPrimal(*currPart);
-            indexAndWeightDual(*currPart);
-
-            currPart->Ex = interpol_(Ex, ExCentering, startIndex, weights);
-            currPart->Ey = interpol_(Ey, EyCentering, startIndex, weights);
-            currPart->Ez = interpol_(Ez, EzCentering, startIndex, weights);
-            currPart->Bx = interpol_(Bx, BxCentering, startIndex, weights);
-            currPart->By = interpol_(By, ByCentering, startIndex, weights);
-            currPart->Bz = interpol_(Bz, BzCentering, startIndex, weights);
+            shapes.load(iPart, startIndex, weights);
+            auto const fields = interpolateFields_(Ex, Ey, Ez, Bx, By, Bz);
+
+            currPart->Ex = fields.Ex;
+            currPart->Ey = fields.Ey;
+            currPart->Ez = fields.Ez;
+            currPart->Bx = fields.Bx;
+            currPart->By = fields.By;
+            currPart->Bz = fields.Bz;
         }
     }
 
 
+
+    /**\brief interpolate electromagnetic fields on a single particle and return them
+     *
+     * Unlike the range overload, fields are not stored on the particle. This is used
+     * by pushers that accelerate each particle right after having interpolated the
+     * fields at its position.
+     */
+    template<typename Particle, typename Electromag>
+    inline EMFieldsAtParticle operator()(Particle const& particle, Electromag const& Em)
+    {
+        return interpolate_(particle, Em.E.getComponent(Component::X),
+                            Em.E.getComponent(Component::Y), Em.E.getComponent(Component::Z),
+                            Em.B.getComponent(Component::X), Em.B.getComponent(Component::Y),
+                            Em.B.getComponent(Component::Z));
+    }
+
+
 private:
     static_assert(GridLayout::dimension <= 3 && GridLayout::dimension > 0
                       && GridLayout::interp_order >= 1 && GridLayout::interp_order <= 3,
@@ -354,14 +404,82 @@ private:
                2>
         weights;
 
-    /**
-     * @brief dualOffset returns the offset by which changing the
-     * startIndex for dual node interpolation. This offset depends on
-     * interpolation order. */
-    inline constexpr double dualOffset(int order)
+    // calculates the startIndex and the order+1 weights for
+    // dual field interpolation and puts this at the corresponding location
+    // in 'startIndex' and 'weights'. For dual fields, the normalizedPosition
+    // is offseted compared to primal ones.
+    template<typename Particle>
+    inline void indexAndWeightDual_(Particle const& part)
+    {
+        for (auto iDim = 0u; iDim < GridLayout::dimension; ++iDim)
+        {
+            double normalizedPos
+                = part.iCell[iDim] + part.delta[iDim] + dualOffset(GridLayout::interp_order);
+
+            startIndex[centering2int(QtyCentering::dual)][iDim]
+                = computeStartIndex<GridLayout::interp_order>(normalizedPos);
+
+            weightComputer_.computeWeight(normalizedPos,
+                                          startIndex[centering2int(QtyCentering::dual)][iDim],
+                                          weights[centering2int(QtyCentering::dual)][iDim]);
+        }
+    }
+
+
+    // does the same as above but for a primal field
+    template<typename Particle>
+    inline void indexAndWeightPrimal_(Particle const& part)
+    {
+        for (auto iDim = 0u; iDim < GridLayout::dimension; ++iDim)
+        {
+            double normalizedPos = part.iCell[iDim] + part.delta[iDim];
+
+            startIndex[centering2int(QtyCentering::primal)][iDim]
+                = computeStartIndex<GridLayout::interp_order>(normalizedPos);
+
+            weightComputer_.computeWeight(normalizedPos,
+                                          startIndex[centering2int(QtyCentering::primal)][iDim],
+                                          weights[centering2int(QtyCentering::primal)][iDim]);
+        }
+    }
+
+
+    // first calculate the startIndex and weights for dual and primal quantities.
+    // then, knowing the centering (primal or dual) of each electromagnetic
+    // component, we use Interpol to actually perform the interpolation.
+    // the trick here is that the StartIndex and weights have only been calculated
+    // twice, and not for each E,B component.
+    template<typename Particle, typename Field>
+    inline EMFieldsAtParticle interpolate_(Particle const& part, Field const& Ex, Field const& Ey,
+                                           Field const& Ez, Field const& Bx, Field const& By,
+                                           Field const& Bz)
+    {
+        indexAndWeightPrimal_(part);
+        indexAndWeightDual_(part);
+
+        return interpolateFields_(Ex, Ey, Ez, Bx, By, Bz);
+    }
+
+
+    // interpolate the components with the current startIndex and weights
+    template<typename Field>
+    inline EMFieldsAtParticle interpolateFields_(Field const& Ex, Field const& Ey,
+                                                 Field const& Ez, Field const& Bx,
+                                                 Field const& By, Field const& Bz)
     {
-        std::array<double, 3> offsets = {{-0.5, -0.5, 0.5}};
-        return offsets[static_cast<std::array<double, 3>::size_type>(order - 1)];
+        constexpr auto ExCentering = GridLayout::centering(HybridQuantity::Scalar::Ex);
+        constexpr auto EyCentering = GridLayout::centering(HybridQuantity::Scalar::Ey);
+        constexpr auto EzCentering = GridLayout::centering(HybridQuantity::Scalar::Ez);
+        constexpr auto BxCentering = GridLayout::centering(HybridQuantity::Scalar::Bx);
+        constexpr auto ByCentering = GridLayout::centering(HybridQuantity::Scalar::By);
+        constexpr auto BzCentering = GridLayout::centering(HybridQuantity::Scalar::Bz);
+
+        return {interpol_(Ex, ExCentering, startIndex, weights),
+                interpol_(Ey, EyCentering, startIndex, weights),
+                interpol_(Ez, EzCentering, startIndex, weights),
+                interpol_(Bx, BxCentering, startIndex, weights),
+                interpol_(By, ByCentering, startIndex, weights),
+                interpol_(Bz, BzCentering, startIndex, weights)};
     }
 };
 
@@ -0,0 +1,130 @@
+#ifndef PHARE_CORE_NUMERICS_INTERPOLATOR_SHAPE_CACHE_H
+#define PHARE_CORE_NUMERICS_INTERPOLATOR_SHAPE_CACHE_H
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include "data/grid/gridlayoutdefs.h"
+#include "numerics/interpolator/interpolator.h"
+
+namespace PHARE
+{
+/** \brief ShapeCache stores the start indexes and weights of the particles of a range, for
+ * primal and dual nodes, as computed by Interpolator and MomentsDepositor.
+ *
+ * update() computes them once after the positions of the particles have changed, and both
+ * the interpolation of the fields (Interpolator) and the deposition of the moments
+ * (MomentsDepositor) can then read them instead of computing them again. Indexes and weights
+ * are stored by centering and direction, each in its own array over the particles.
+ *
+ * The cache is only valid for the range it was last updated with, as long as the positions
+ * of its particles are not modified. Only the number of particles is checked.
+ *
+ * Only orders for which ShapeCachePolicy is enabled can be cached.
+ */
+template<std::size_t dim, std::size_t interpOrder>
+class ShapeCache
+{
+    static_assert(ShapeCachePolicy<interpOrder>::enabled,
+                  "shapes are not cached at this interpolation order, see ShapeCachePolicy");
+
+public:
+    static constexpr std::size_t nbrPoints = nbrPointsSupport(interpOrder);
+
+    // array[dual/primal][dim], as used by Interpol
+    using start_index_type = std::array<std::array<int, dim>, 2>;
+    using weights_type     = std::array<std::array<std::array<double, nbrPoints>, dim>, 2>;
+
+
+    //! compute the shape factors of the particles in [begin, end[
+    template<typename PartIterator>
+    void update(PartIterator begin, PartIterator end)
+    {
+        auto const nbrParticles = static_cast<std::size_t>(std::distance(begin, end));
+
+        for (auto iCentering = 0u; iCentering < 2; ++iCentering)
+        {
+            for (auto iDim = 0u; iDim < dim; ++iDim)
+            {
+                startIndex_[iCentering][iDim].resize(nbrParticles);
+                weights_[iCentering][iDim].resize(nbrParticles);
+            }
+        }
+
+        auto const iPrimal = centering2int(QtyCentering::primal);
+        auto const iDual   = centering2int(QtyCentering::dual);
+
+        std::size_t iPart = 0;
+        for (auto currPart = begin; currPart != end; ++currPart, ++iPart)
+        {
+            auto const& part = *currPart;
+            for (auto iDim = 0u; iDim < dim; ++iDim)
+            {
+                double const normalizedPos = part.iCell[iDim] + part.delta[iDim];
+                compute_(normalizedPos, iPrimal, iDim, iPart);
+                compute_(normalizedPos + dualOffset(interpOrder), iDual, iDim, iPart);
+            }
+        }
+
+        size_ = nbrParticles;
+    }
+
+
+
+    std::size_t size() const { return size_; }
+
+
+
+    //! copy the shape factors of the iPart-th particle of the range to startIndex and weights
+    void load(std::size_t iPart, start_index_type& startIndex, weights_type& weights) const
+    {
+        for (auto iCentering = 0u; iCentering < 2; ++iCentering)
+        {
+            for (auto iDim = 0u; iDim < dim; ++iDim)
+            {
+                startIndex[iCentering][iDim] = startIndex_[iCentering][iDim][iPart];
+                weights[iCentering][iDim]    = weights_[iCentering][iDim][iPart];
+            }
+        }
+    }
+
+
+
+    //! throws if the cache was not updated with a range of nbrParticles particles
+    void checkSize(std::size_t nbrParticles) const
+    {
+        if (nbrParticles != size_)
+        {
+            throw std::runtime_error("Error - ShapeCache does not match the particle range");
+        }
+    }
+
+
+
+private:
+    Weighter<interpOrder> weightComputer_;
+
+    std::array<std::array<std::vector<int>, dim>, 2> startIndex_;
+    std::array<std::array<std::vector<std::array<double, nbrPoints>>, dim>, 2> weights_;
+    std::size_t size_ = 0;
+
+
+    void compute_(double normalizedPos, std::size_t iCentering, std::size_t iDim,
+                  std::size_t iPart)
+    {
+        auto& startIndex = startIndex_[iCentering][iDim][iPart];
+
+        startIndex = computeStartIndex<interpOrder>(normalizedPos);
+        weightComputer_.computeWeight(normalizedPos, startIndex,
+                                      weights_[iCentering][iDim][iPart]);
+    }
+};
+
+
+
+} // namespace PHARE
+
+#endif
@@ -0,0 +1,408 @@
+#ifndef PHARE_CORE_NUMERICS_MOMENTS_MOMENTS_H
+#define PHARE_CORE_NUMERICS_MOMENTS_MOMENTS_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "data/field/field.h"
+#include "data/grid/gridlayout.h"
+#include "data/ndarray/ndarray_vector.h"
+#include "data/vecfield/vecfield_component.h"
+#include "hybrid/hybrid_quantities.h"
+#include "numerics/interpolator/interpolator.h"
+#include "utilities/parallel/parallel_for.h"
+
+namespace PHARE
+{
+/** \brief MomentsDepositor computes the density and the flux of particles on the grid,
+ * i.e. it accumulates weight*shape and weight*v*shape at the nodes around each particle.
+ *
+ * Shape functions are those of Weighter<interp_order>, evaluated at the primal or dual
+ * nodes depending on the centering the GridLayout gives to the density and to the flux
+ * components, so that deposition is the transpose of the interpolation done by Interpolator.
+ *
+ * The depositor can split the particles in chunks processed concurrently by nbrThreads
+ * threads. Each chunk then deposits into its own accumulation fields, and the moments are
+ * obtained by adding the accumulation fields node by node, always in chunk order. The result
+ * does not depend on thread scheduling and no atomic operation is needed. The accumulation
+ * fields are kept by the depositor and only zeroed between deposits, so that a depositor
+ * is not to be used by several threads at once.
+ */
+template<typename GridLayout>
+class MomentsDepositor
+{
+public:
+    static constexpr std::size_t dimension    = GridLayout::dimension;
+    static constexpr std::size_t interp_order = GridLayout::interp_order;
+
+
+    explicit MomentsDepositor(std::size_t nbrThreads = 1)
+        : nbrThreads_{std::max(nbrThreads, std::size_t{1})}
+    {
+    }
+
+
+
+    /** \brief add the density and flux of the particles in [begin, end[ to the given fields
+     *
+     * The fields are not reset, so that several particle arrays (e.g. domain and ghost
+     * particles) can be deposited one after the other. The layout is used to allocate
+     * the accumulation fields of the chunks when particles are deposited concurrently.
+     */
+    template<typename PartIterator, typename Field, typename VecField, typename Layout>
+    void operator()(PartIterator begin, PartIterator end, Field& density, VecField& flux,
+                    Layout const& layout)
+    {
+        auto const nbrParticles = static_cast<std::size_t>(std::distance(begin, end));
+
+        depositChunks_(nbrParticles, density, flux, layout,
+                       [&](std::size_t first, std::size_t last, Field& chunkDensity,
+                           Field& chunkFluxX, Field& chunkFluxY, Field& chunkFluxZ) {
+                           Deposit{}(begin + first, begin + last, chunkDensity, chunkFluxX,
+                                     chunkFluxY, chunkFluxZ);
+                       });
+    }
+
+
+
+    /** \brief same as above, but the start indexes and weights of the particles are read
+     * from a ShapeCache updated with the same range, instead of being computed
+     *
+     * Throws if the cache and the range do not have the same size. Only available at the
+     * orders for which ShapeCachePolicy is enabled.
+     */
+    template<typename PartIterator, typename Field, typename VecField, typename Layout,
+             typename ShapeCache>
+    void operator()(PartIterator begin, PartIterator end, Field& density, VecField& flux,
+                    Layout const& layout, ShapeCache const& shapes)
+    {
+        static_assert(ShapeCachePolicy<interp_order>::enabled,
+                      "shapes are not cached at this interpolation order");
+
+        auto const nbrParticles = static_cast<std::size_t>(std::distance(begin, end));
+
+        shapes.checkSize(nbrParticles);
+
+        depositChunks_(nbrParticles, density, flux, layout,
+                       [&](std::size_t first, std::size_t last, Field& chunkDensity,
+                           Field& chunkFluxX, Field& chunkFluxY, Field& chunkFluxZ) {
+                           Deposit{}(begin + first, begin + last, shapes, first, chunkDensity,
+                                     chunkFluxX, chunkFluxY, chunkFluxZ);
+                       });
+    }
+
+
+
+    /** \brief compute the density and flux of an ion population from its domain and
+     * ghost particles. The moments of the population are reset first.
+     */
+    template<typename IonPopulation, typename Layout>
+    void operator()(IonPopulation& population, Layout const& layout)
+    {
+        auto& density = population.density();
+        auto& flux    = population.flux();
+
+        density.zero();
+        flux.getComponent(Component::X).zero();
+        flux.getComponent(Component::Y).zero();
+        flux.getComponent(Component::Z).zero();
+
+        auto& domainParticles = population.domainParticles();
+        auto& ghostParticles  = population.ghostParticles();
+
+        (*this)(std::begin(domainParticles), std::end(domainParticles), density, flux, layout);
+        (*this)(std::begin(ghostParticles), std::end(ghostParticles), density, flux, layout);
+    }
+
+
+
+
+private:
+    static_assert(dimension <= 3 && dimension > 0 && interp_order >= 1 && interp_order <= 3,
+                  "error");
+
+    static constexpr std::size_t minParticlesPerThread_ = 4096;
+    static constexpr std::size_t nbrPoints_             = nbrPointsSupport(interp_order);
+
+    std::size_t nbrThreads_;
+
+
+    using accumulator_array_type = std::conditional_t<
+        dimension == 1, NdArrayVector1D<>,
+        std::conditional_t<dimension == 2, NdArrayVector2D<>, NdArrayVector3D<>>>;
+    using accumulator_type = Field<accumulator_array_type, HybridQuantity::Scalar>;
+
+    //! accumulation fields of a chunk, when particles are deposited concurrently
+    struct ChunkAccumulators
+    {
+        accumulator_type density;
+        accumulator_type fluxX;
+        accumulator_type fluxY;
+        accumulator_type fluxZ;
+    };
+
+    // kept from one deposit to the next, and rebuilt when the layout gives other shapes
+    std::vector<ChunkAccumulators> accumulators_;
+    std::array<std::array<uint32, dimension>, 4> accumulatorSizes_{};
+
+
+
+    /** Deposit holds the start indexes and weights of the particle being deposited, for
+     * primal and dual nodes, as Interpolator does for the interpolation. They are computed
+     * from the position of the particle or read from a ShapeCache.
+     */
+    class Deposit
+    {
+    public:
+        template<typename PartIterator, typename Field>
+        void operator()(PartIterator begin, PartIterator end, Field& density, Field& fluxX,
+                        Field& fluxY, Field& fluxZ)
+        {
+            for (auto currPart = begin; currPart != end; ++currPart)
+            {
+                auto const& part = *currPart;
+
+                indexAndWeight_(part, QtyCentering::primal, 0.);
+                indexAndWeight_(part, QtyCentering::dual, dualOffset(interp_order));
+
+                deposit_(part, density, fluxX, fluxY, fluxZ);
+            }
+        }
+
+
+        // the shapes of the particle at begin are the firstShape-th ones of the cache
+        template<typename PartIterator, typename ShapeCache, typename Field>
+        void operator()(PartIterator begin, PartIterator end, ShapeCache const& shapes,
+                        std::size_t firstShape, Field& density, Field& fluxX, Field& fluxY,
+                        Field& fluxZ)
+        {
+            auto iShape = firstShape;
+            for (auto currPart = begin; currPart != end; ++currPart, ++iShape)
+            {
+                shapes.load(iShape, startIndex_, weights_);
+
+                deposit_(*currPart, density, fluxX, fluxY, fluxZ);
+            }
+        }
+
+
+    private:
+        Weighter<interp_order> weightComputer_;
+
+        // array[dual/primal][dim]
+        std::array<std::array<int, dimension>, 2> startIndex_;
+        std::array<std::array<std::array<double, nbrPoints_>, dimension>, 2> weights_;
+
+
+        template<typename Particle>
+        void indexAndWeight_(Particle const& part, QtyCentering centering, double offset)
+        {
+            auto const iCentering = centering2int(centering);
+
+            for (auto iDim = 0u; iDim < dimension; ++iDim)
+            {
+                double normalizedPos = part.iCell[iDim] + part.delta[iDim] + offset;
+
+                startIndex_[iCentering][iDim] = computeStartIndex<interp_order>(normalizedPos);
+
+                weightComputer_.computeWeight(normalizedPos, startIndex_[iCentering][iDim],
+                                              weights_[iCentering][iDim]);
+            }
+        }
+
+
+        template<typename Particle, typename Field>
+        void deposit_(Particle const& part, Field& density, Field& fluxX, Field& fluxY,
+                      Field& fluxZ)
+        {
+            constexpr auto rhoCentering = GridLayout::centering(HybridQuantity::Scalar::rho);
+            constexpr auto VxCentering  = GridLayout::centering(HybridQuantity::Scalar::Vx);
+            constexpr auto VyCentering  = GridLayout::centering(HybridQuantity::Scalar::Vy);
+            constexpr auto VzCentering  = GridLayout::centering(HybridQuantity::Scalar::Vz);
+
+            add_(density, rhoCentering, part.weight);
+            add_(fluxX, VxCentering, part.weight * part.v[0]);
+            add_(fluxY, VyCentering, part.weight * part.v[1]);
+            add_(fluxZ, VzCentering, part.weight * part.v[2]);
+        }
+
+
+        // add value*shape to the order+1 nodes of each direction around the particle
+        template<typename Field>
+        void add_(Field& field, std::array<QtyCentering, dimension> const& centering,
+                  double value)
+        {
+            auto const& xStartIndex = startIndex_[centering2int(centering[0])][0];
+            auto const& xWeights    = weights_[centering2int(centering[0])][0];
+
+            if constexpr (dimension == 1)
+            {
+                for (auto ix = 0u; ix < nbrPoints_; ++ix)
+                {
+                    field(xStartIndex + ix) += value * xWeights[ix];
+                }
+            }
+            else
+            {
+                auto const& yStartIndex = startIndex_[centering2int(centering[1])][1];
+                auto const& yWeights    = weights_[centering2int(centering[1])][1];
+
+                if constexpr (dimension == 2)
+                {
+                    for (auto ix = 0u; ix < nbrPoints_; ++ix)
+                    {
+                        auto const xValue = value * xWeights[ix];
+                        for (auto iy = 0u; iy < nbrPoints_; ++iy)
+                        {
+                            field(xStartIndex + ix, yStartIndex + iy) += xValue * yWeights[iy];
+                        }
+                    }
+                }
+                else
+                {
+                    auto const& zStartIndex = startIndex_[centering2int(centering[2])][2];
+                    auto const& zWeights    = weights_[centering2int(centering[2])][2];
+
+                    for (auto ix = 0u; ix < nbrPoints_; ++ix)
+                    {
+                        auto const xValue = value * xWeights[ix];
+                        for (auto iy = 0u; iy < nbrPoints_; ++iy)
+                        {
+                            auto const xyValue = xValue * yWeights[iy];
+                            for (auto iz = 0u; iz < nbrPoints_; ++iz)
+                            {
+                                field(xStartIndex + ix, yStartIndex + iy, zStartIndex + iz)
+                                    += xyValue * zWeights[iz];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+
+
+    /** deposit nbrParticles particles with depositChunk(first, last, density, fluxX, fluxY,
+     * fluxZ), which deposits the particles [first, last[ of the range into the given fields.
+     * With several chunks, each one has its own accumulation fields, reduced afterwards.
+     */
+    template<typename Field, typename VecField, typename Layout, typename DepositChunk>
+    void depositChunks_(std::size_t nbrParticles, Field& density, VecField& flux,
+                        Layout const& layout, DepositChunk&& depositChunk)
+    {
+        auto& fluxX = flux.getComponent(Component::X);
+        auto& fluxY = flux.getComponent(Component::Y);
+        auto& fluxZ = flux.getComponent(Component::Z);
+
+        auto const nbrChunks = nbrChunks_(nbrParticles);
+
+        if (nbrChunks == 1)
+        {
+            depositChunk(0, nbrParticles, density, fluxX, fluxY, fluxZ);
+            return;
+        }
+
+        prepareAccumulators_(nbrChunks, density, fluxX, fluxY, fluxZ, layout);
+
+        parallelForChunks(nbrParticles, nbrChunks,
+                          [&](std::size_t first, std::size_t last, std::size_t iChunk) {
+                              auto& chunk = accumulators_[iChunk];
+
+                              chunk.density.zero();
+                              chunk.fluxX.zero();
+                              chunk.fluxY.zero();
+                              chunk.fluxZ.zero();
+
+                              depositChunk(first, last, chunk.density, chunk.fluxX, chunk.fluxY,
+                                           chunk.fluxZ);
+                          });
+
+        reduce_(nbrChunks, &ChunkAccumulators::density, density);
+        reduce_(nbrChunks, &ChunkAccumulators::fluxX, fluxX);
+        reduce_(nbrChunks, &ChunkAccumulators::fluxY, fluxY);
+        reduce_(nbrChunks, &ChunkAccumulators::fluxZ, fluxZ);
+    }
+
+
+
+    std::size_t nbrChunks_(std::size_t nbrParticles) const
+    {
+        return std::max(std::size_t{1},
+                        std::min(nbrThreads_, nbrParticles / minParticlesPerThread_));
+    }
+
+
+
+    /** make sure there are accumulation fields for nbrChunks chunks, shaped as the given
+     * fields on the layout. They are only rebuilt when the layout gives other shapes.
+     */
+    template<typename Field, typename Layout>
+    void prepareAccumulators_(std::size_t nbrChunks, Field const& density, Field const& fluxX,
+                              Field const& fluxY, Field const& fluxZ, Layout const& layout)
+    {
+        std::array<std::array<uint32, dimension>, 4> const sizes{
+            {layout.allocSize(density.physicalQuantity()),
+             layout.allocSize(fluxX.physicalQuantity()),
+             layout.allocSize(fluxY.physicalQuantity()),
+             layout.allocSize(fluxZ.physicalQuantity())}};
+
+        if (sizes != accumulatorSizes_)
+        {
+            accumulators_.clear();
+            accumulatorSizes_ = sizes;
+        }
+
+        while (accumulators_.size() < nbrChunks)
+        {
+            accumulators_.push_back({accumulator_(density, sizes[0]), accumulator_(fluxX, sizes[1]),
+                                     accumulator_(fluxY, sizes[2]), accumulator_(fluxZ, sizes[3])});
+        }
+    }
+
+
+
+    //! an accumulation field for field, of the given size
+    template<typename Field>
+    static accumulator_type accumulator_(Field const& field,
+                                         std::array<uint32, dimension> const& size)
+    {
+        return accumulator_type{field.name() + "_accumulator", field.physicalQuantity(), size};
+    }
+
+
+
+    /** add the given accumulation field of the nbrChunks first chunks to field. Nodes are
+     * split between threads, and each node sums the chunks in chunk order.
+     */
+    template<typename Field>
+    void reduce_(std::size_t nbrChunks, accumulator_type ChunkAccumulators::*accumulator,
+                 Field& field)
+    {
+        auto const nbrNodes = static_cast<std::size_t>(std::distance(field.begin(), field.end()));
+        auto const nbrNodeChunks = std::min(nbrChunks, std::max(std::size_t{1}, nbrNodes));
+
+        parallelForChunks(nbrNodes, nbrNodeChunks, [&](std::size_t first, std::size_t last,
+                                                       std::size_t) {
+            auto out = field.begin() + static_cast<std::ptrdiff_t>(first);
+            for (auto node = first; node < last; ++node, ++out)
+            {
+                for (std::size_t iChunk = 0; iChunk < nbrChunks; ++iChunk)
+                {
+                    auto const& chunkField = accumulators_[iChunk].*accumulator;
+                    *out += *(chunkField.begin() + static_cast<std::ptrdiff_t>(node));
+                }
+            }
+        });
+    }
+};
+
+
+
+} // namespace PHARE
+
+#endif
@@ -1,23 +1,59 @@
 #ifndef PHARE_CORE_PUSHER_BORIS_H
 #define PHARE_CORE_PUSHER_BORIS_H
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstddef>
+#include <numeric>
+#include <utility>
+#include <vector>
 
+#include "data/particles/outgoing_particles.h"
+#include "numerics/pusher/boris_velocity.h"
 #include "numerics/pusher/pusher.h"
+#include "utilities/parallel/parallel_for.h"
 #include "utilities/range/range.h"
 
 namespace PHARE
 {
+/** BorisPusher advances particles with the Boris scheme.
+ *
+ * By default (fusedInterpolation == false) electromagnetic fields are first interpolated
+ * on all particles, which store them in their Ex..Bz members, and the velocities are
+ * updated in a second pass.
+ *
+ * With fusedInterpolation == true, fields are interpolated on each particle into local
+ * variables and used right away to update its velocity. Particles then do not need to
+ * store fields and one sweep over the particles is saved. The Interpolator must provide
+ * a per-particle operator()(particle, electromag) returning the fields.
+ *
+ * The pusher can split the particle ranges in chunks pushed concurrently by nbrThreads
+ * threads. Each thread uses its own copy of the Interpolator. Particles leaving their chunk
+ * are then gathered so that move() returns the same partition as the serial push, up to
+ * the order of the particles within each side of the partition.
+ *
+ * A move() overload taking OutgoingParticles copies leaving particles directly into the
+ * buckets of the directions they leave through, instead of swapping them to the end of
+ * the range. It applies no boundary condition and is only for patches that do not touch a
+ * physical boundary. Another overload, also taking the BoundaryCondition, gathers the
+ * leaving particles the same way, gives them to the boundary condition and puts in the
+ * buckets those it drops.
+ */
 template<std::size_t dim, typename ParticleIterator, typename Electromag, typename Interpolator,
-         typename ParticleSelector, typename BoundaryCondition>
+         typename ParticleSelector, typename BoundaryCondition, bool fusedInterpolation = false>
 class BorisPusher : public Pusher<dim, ParticleIterator, Electromag, Interpolator, ParticleSelector,
                                   BoundaryCondition>
 {
 public:
     using ParticleRange = Range<ParticleIterator>;
 
+    explicit BorisPusher(std::size_t nbrThreads = 1)
+        : nbrThreads_{std::max(nbrThreads, std::size_t{1})}
+    {
+    }
+
+
     /** see Pusher::move() domentation*/
     virtual ParticleIterator move(ParticleRange const& rangeIn, ParticleRange& rangeOut,
                                   Electromag const& emFields, double mass,
@@ -39,12 +75,9 @@ public:
 
         rangeOut = makeRange(rangeOut.begin(), std::move(newEnd));
 
-        // get electromagnetic fields interpolated on the particles of rangeOut
-        // stop at newEnd.
-        interpolator(rangeOut.begin(), rangeOut.end(), emFields);
-
         // get the particle velocity from t=n to t=n+1
-        accelerate_(rangeOut, rangeOut, mass);
+        // using the electromagnetic fields interpolated on the particles of rangeOut
+        accelerate_(rangeOut, emFields, interpolator, mass);
 
         // now advance the particles from t=n+1/2 to t=n+1 using v_{n+1} just calculated
         // and get a pointer to the first leaving particle
@@ -73,12 +106,9 @@ public:
 
         rangeOut = makeRange(rangeOut.begin(), std::move(firstLeaving));
 
-        // get electromagnetic fields interpolated on the particles of rangeOut
-        // stop at newEnd.
-        interpolator(rangeOut.begin(), rangeOut.end(), emFields);
-
         // get the particle velocity from t=n to t=n+1
-        accelerate_(rangeOut, rangeOut, mass);
+        // using the electromagnetic fields interpolated on the particles of rangeOut
+        accelerate_(rangeOut, emFields, interpolator, mass);
 
         // now advance the particles from t=n+1/2 to t=n+1 using v_{n+1} just calculated
         // and get a pointer to the first leaving particle
@@ -90,6 +120,63 @@ public:
     }
 
 
+    /** this overload of move() does the same as the one above, but particles leaving the patch
+     * are put in the outgoing buckets, with their cell in AMR index space, as soon as they are
+     * detected. Leaving particles are not swapped with staying ones: their place in rangeOut is
+     * taken by a particle from the end of the range, and particles in [pivot, rangeOut.end[
+     * are left in an unspecified state and are to be erased.
+     *
+     * No boundary condition is applied, so that this overload is only for patches that do not
+     * touch a physical boundary: a particle leaving through one would be put in a bucket.
+     */
+    ParticleIterator move(ParticleRange const& rangeIn, ParticleRange& rangeOut,
+                          Electromag const& emFields, double mass, Interpolator& interpolator,
+                          ParticleSelector const& particleIsNotLeaving,
+                          OutgoingParticles<dim>& outgoing)
+    {
+        auto firstLeaving = pushStepOutgoing_(rangeIn, rangeOut, particleIsNotLeaving, outgoing);
+
+        rangeOut = makeRange(rangeOut.begin(), std::move(firstLeaving));
+
+        accelerate_(rangeOut, emFields, interpolator, mass);
+
+        firstLeaving = pushStepOutgoing_(rangeOut, rangeOut, particleIsNotLeaving, outgoing);
+
+        rangeOut = makeRange(rangeOut.begin(), std::move(firstLeaving));
+
+        return rangeOut.end();
+    }
+
+
+    /** this overload of move() is the one taking the BoundaryCondition, for patches touching a
+     * physical boundary. Leaving particles are not swapped either: they are copied aside and
+     * their place is taken by a particle from the end of the range. After each half step, the
+     * leaving particles are given to the boundary condition, those it keeps are copied back
+     * after the staying ones, and those it drops, which leave through a non-physical boundary,
+     * are put in the outgoing buckets with their cell in AMR index space. Particles in
+     * [pivot, rangeOut.end[ are left in an unspecified state and are to be erased.
+     */
+    ParticleIterator move(ParticleRange const& rangeIn, ParticleRange& rangeOut,
+                          Electromag const& emFields, double mass, Interpolator& interpolator,
+                          ParticleSelector const& particleIsNotLeaving, BoundaryCondition& bc,
+                          OutgoingParticles<dim>& outgoing)
+    {
+        auto firstLeaving = pushStepOutgoing_(rangeIn, rangeOut, particleIsNotLeaving, leaving_);
+        auto newEnd       = applyBCAndBucket_(firstLeaving, bc, outgoing);
+
+        rangeOut = makeRange(rangeOut.begin(), std::move(newEnd));
+
+        accelerate_(rangeOut, emFields, interpolator, mass);
+
+        firstLeaving = pushStepOutgoing_(rangeOut, rangeOut, particleIsNotLeaving, leaving_);
+        newEnd       = applyBCAndBucket_(firstLeaving, bc, outgoing);
+
+        rangeOut = makeRange(rangeOut.begin(), std::move(newEnd));
+
+        return rangeOut.end();
+    }
+
+
     /** see Pusher::move() domentation*/
     virtual void setMeshAndTimeStep(std::array<double, dim> ms, double ts) override
     {
@@ -102,9 +189,11 @@ public:
 
 private:
     /** move the particle partIn of half a time step and store it in partOut
+     * partOut is taken by forwarding reference so that it can be either a Particle
+     * or a proxy on a particle, as returned by ParticleArraySoA iterators.
      */
-    template<typename ParticleIter>
-    void advancePosition_(ParticleIter const& partIn, ParticleIter& partOut)
+    template<typename ParticleIn, typename ParticleOut>
+    void advancePosition_(ParticleIn const& partIn, ParticleOut&& partOut)
     {
         // push the particle
         for (std::size_t iDim = 0; iDim < dim; ++iDim)
@@ -120,25 +209,247 @@ private:
 
 
 
+    /** apply the boundary condition on the leaving particles gathered in leaving_, put those
+     * it drops in the outgoing buckets and copy those it keeps from firstLeaving on
+     * @return the function returns the end of the particles kept in the range
+     */
+    ParticleIterator applyBCAndBucket_(ParticleIterator firstLeaving, BoundaryCondition& bc,
+                                       OutgoingParticles<dim>& outgoing)
+    {
+        auto kept = bc.applyOutgoingParticleBC(std::begin(leaving_), std::end(leaving_));
+
+        for (auto leaving = kept; leaving != std::end(leaving_); ++leaving)
+        {
+            outgoing.push_back(*leaving);
+        }
+
+        auto newEnd = firstLeaving;
+        for (auto leaving = std::begin(leaving_); leaving != kept; ++leaving, ++newEnd)
+        {
+            *newEnd = *leaving;
+        }
+
+        leaving_.clear();
+        return newEnd;
+    }
+
+
+
+    //! number of chunks in which to split a range of nbrParticles particles
+    std::size_t nbrChunks_(std::size_t nbrParticles) const
+    {
+        return std::max(std::size_t{1},
+                        std::min(nbrThreads_, nbrParticles / minParticlesPerThread_));
+    }
+
+
+
+
     /** advance the particles in rangeIn of half a time step and store them
      * in rangeOut.
+     * Ranges are split in chunks pushed concurrently, and the leaving particles found
+     * at the end of each chunk are then gathered at the end of rangeOut.
      * @return the function returns and iterator on the first leaving particle, as
      * detected by the ParticleSelector
      */
-    template<typename ParticleRangeIn, typename ParticleRangeOut>
-    auto pushStep_(ParticleRangeIn const& rangeIn, ParticleRangeOut& rangeOut,
+    auto pushStep_(ParticleRange const& rangeIn, ParticleRange& rangeOut,
                    ParticleSelector const& particleIsNotLeaving)
     {
-        auto swapee = rangeOut.end();
-        --swapee;
-        auto newEnd = rangeOut.end();
+        // leaving particles are swapped with the last particle not pushed yet
+        // swap is called unqualified so that proxy particles find their own swap
+        auto swapLeaving = [](auto& leaving, auto& last) {
+            using std::swap;
+            swap(*leaving, *last);
+        };
+
+        auto const nbrParticles = rangeOut.size();
+        auto const nbrChunks    = nbrChunks_(nbrParticles);
+
+        if (nbrChunks == 1)
+        {
+            return pushChunk_(rangeIn, rangeOut, particleIsNotLeaving, swapLeaving);
+        }
+
+        std::vector<std::size_t> nbrStaying(nbrChunks);
+
+        parallelForChunks(nbrParticles, nbrChunks,
+                          [&](std::size_t first, std::size_t last, std::size_t iChunk) {
+                              ParticleRange chunkIn{rangeIn.begin() + first,
+                                                    rangeIn.begin() + last};
+                              ParticleRange chunkOut{rangeOut.begin() + first,
+                                                     rangeOut.begin() + last};
+
+                              auto chunkEnd = pushChunk_(chunkIn, chunkOut, particleIsNotLeaving,
+                                                         swapLeaving);
+                              nbrStaying[iChunk] = chunkEnd - chunkOut.begin();
+                          });
+
+        return gatherLeavingTails_(rangeOut, nbrStaying, swapLeaving);
+    }
+
+
+
+
+    /** same as pushStep_, but leaving particles are put in outgoing, either the outgoing
+     * buckets or leaving_, and their place is taken by the last particle not pushed yet.
+     * Particles past the returned iterator are left in an unspecified state.
+     */
+    template<typename Outgoing>
+    auto pushStepOutgoing_(ParticleRange const& rangeIn, ParticleRange& rangeOut,
+                           ParticleSelector const& particleIsNotLeaving, Outgoing& outgoing)
+    {
+        // leaving particles are not swapped, the last particle is just copied in their place
+        auto moveLast = [](auto& leaving, auto& last) {
+            if (leaving != last)
+            {
+                *leaving = *last;
+            }
+        };
+
+        auto const nbrParticles = rangeOut.size();
+        auto const nbrChunks    = nbrChunks_(nbrParticles);
+
+        if (nbrChunks == 1)
+        {
+            return pushChunk_(rangeIn, rangeOut, particleIsNotLeaving,
+                              [&](auto& leaving, auto& last) {
+                                  outgoing.push_back(*leaving);
+                                  moveLast(leaving, last);
+                              });
+        }
 
+        std::vector<std::size_t> nbrStaying(nbrChunks);
+        std::vector<Outgoing> chunkOutgoing(nbrChunks, emptyLike_(outgoing));
+
+        parallelForChunks(nbrParticles, nbrChunks,
+                          [&](std::size_t first, std::size_t last, std::size_t iChunk) {
+                              ParticleRange chunkIn{rangeIn.begin() + first,
+                                                    rangeIn.begin() + last};
+                              ParticleRange chunkOut{rangeOut.begin() + first,
+                                                     rangeOut.begin() + last};
+
+                              auto chunkEnd = pushChunk_(
+                                  chunkIn, chunkOut, particleIsNotLeaving,
+                                  [&](auto& leaving, auto& lastUnpushed) {
+                                      chunkOutgoing[iChunk].push_back(*leaving);
+                                      moveLast(leaving, lastUnpushed);
+                                  });
+                              nbrStaying[iChunk] = chunkEnd - chunkOut.begin();
+                          });
+
+        for (auto const& leaving : chunkOutgoing)
+        {
+            appendTo_(outgoing, leaving);
+        }
+
+        return gatherLeavingTails_(rangeOut, nbrStaying, moveLast);
+    }
+
+
+
+
+    //! an empty container of leaving particles, to collect those of one chunk of the range
+    static OutgoingParticles<dim> emptyLike_(OutgoingParticles<dim> const& outgoing)
+    {
+        return outgoing.emptyCopy();
+    }
+
+    static std::vector<Particle<dim>> emptyLike_(std::vector<Particle<dim>> const&) { return {}; }
+
+
+    static void appendTo_(OutgoingParticles<dim>& outgoing, OutgoingParticles<dim> const& other)
+    {
+        outgoing.append(other);
+    }
+
+    static void appendTo_(std::vector<Particle<dim>>& leaving,
+                          std::vector<Particle<dim>> const& other)
+    {
+        leaving.insert(std::end(leaving), std::begin(other), std::end(other));
+    }
+
+
+
+
+    /** each chunk of rangeOut has its staying particles first and its leaving ones last.
+     * gatherLeavingTails_ exchanges the leaving particles found before the total number of
+     * staying particles with the staying ones found after it, so that all staying particles
+     * are at the beginning of rangeOut. Only misplaced particles are moved.
+     * @return an iterator on the first leaving particle of rangeOut
+     */
+    template<typename Exchange>
+    ParticleIterator gatherLeavingTails_(ParticleRange& rangeOut,
+                                         std::vector<std::size_t> const& nbrStaying,
+                                         Exchange&& exchange)
+    {
+        auto const nbrParticles = rangeOut.size();
+        auto const nbrChunks    = nbrStaying.size();
+        auto const totalStaying
+            = std::accumulate(std::begin(nbrStaying), std::end(nbrStaying), std::size_t{0});
+
+        std::vector<std::size_t> misplacedLeaving;
+        std::vector<std::size_t> misplacedStaying;
+
+        for (std::size_t iChunk = 0; iChunk < nbrChunks; ++iChunk)
+        {
+            auto const bounds   = chunkBounds(nbrParticles, nbrChunks, iChunk);
+            auto const chunkEnd = bounds.first + nbrStaying[iChunk];
+
+            for (auto i = chunkEnd; i < std::min(bounds.second, totalStaying); ++i)
+            {
+                misplacedLeaving.push_back(i);
+            }
+            for (auto i = std::max(bounds.first, totalStaying); i < chunkEnd; ++i)
+            {
+                misplacedStaying.push_back(i);
+            }
+        }
+
+        for (std::size_t i = 0; i < misplacedLeaving.size(); ++i)
+        {
+            auto leaving = rangeOut.begin() + misplacedLeaving[i];
+            auto staying = rangeOut.begin() + misplacedStaying[i];
+            exchange(leaving, staying);
+        }
+
+        return rangeOut.begin() + totalStaying;
+    }
+
+
+
+
+    /** advance the particles in rangeIn of half a time step and store them
+     * in rangeOut.
+     * A leaving particle is given to onLeaving(leaving, last) together with the last
+     * particle not pushed yet, which onLeaving must put in place of the leaving one.
+     * @return the function returns and iterator on the first leaving particle, as
+     * detected by the ParticleSelector
+     */
+    template<typename ParticleRangeIn, typename ParticleRangeOut, typename OnLeaving>
+    auto pushChunk_(ParticleRangeIn const& rangeIn, ParticleRangeOut& rangeOut,
+                    ParticleSelector const& particleIsNotLeaving, OnLeaving&& onLeaving)
+    {
+        auto newEnd     = rangeOut.end();
         auto currentOut = rangeOut.begin();
+        auto currentIn  = rangeIn.begin();
 
-        for (auto currentIn : rangeIn)
+        // a particle swapped in from the tail of rangeOut has not been pushed yet
+        // and, per the contract of move(), has the same state as its rangeIn copy,
+        // so it is pushed from itself rather than from currentIn
+        bool swappedIn = false;
+
+        while (currentOut != newEnd)
         {
             // push the particle
-            advancePosition_(currentIn, *currentOut);
+            if (swappedIn)
+            {
+                Particle<dim> const particleIn = *currentOut;
+                advancePosition_(particleIn, *currentOut);
+            }
+            else
+            {
+                advancePosition_(*currentIn, *currentOut);
+            }
 
             if (particleIsNotLeaving(*currentOut))
             {
@@ -146,16 +457,16 @@ private:
                 // only if currentOut has not been
                 // swapped
                 ++currentOut;
+                ++currentIn;
+                swappedIn = false;
             }
             else
             {
-                // if the particle satisfies the predicate
-                // swap it with the swapee
-                // and decrement the swapee
-
-                std::swap(*currentOut, *swapee);
+                // if the particle is leaving, the last particle
+                // not yet pushed takes its place and is pushed next
                 --newEnd;
-                --swapee;
+                onLeaving(currentOut, newEnd);
+                swappedIn = true;
             }
         }
 
@@ -169,80 +480,95 @@ private:
 
 
 
-    /** Accelerate the particles in rangeIn and put the new velocity in rangeOut
+    /** Accelerate the particles in the range, with fields interpolated
+     * either in a first pass stored on the particles, or particle by particle
+     * if the pusher is fused.
+     *
+     * Velocities are updated by batches of BorisBatch::size particles so that
+     * borisVelocityBatch() can process them with SIMD instructions.
      */
-    template<typename ParticleRangeIn, typename ParticleRangeOut>
-    void accelerate_(ParticleRangeIn inputParticles, ParticleRangeOut outputParticles, double mass)
+    void accelerate_(ParticleRange& particles, Electromag const& emFields,
+                     Interpolator& interpolator, double mass)
     {
-        double dto2m = 0.5 * dt_ / mass;
-
-        auto currentOut = outputParticles.begin();
+        auto const nbrParticles = particles.size();
+        auto const nbrChunks    = nbrChunks_(nbrParticles);
 
-        for (auto const& currentIn : inputParticles)
+        if (nbrChunks == 1)
         {
-            double coef1 = currentIn.charge * dto2m;
-
-            // We now apply the 3 steps of the BORIS PUSHER
-
-            // 1st half push of the electric field
-            double velx1 = currentIn.v[0] + coef1 * currentIn.Ex;
-            double vely1 = currentIn.v[1] + coef1 * currentIn.Ey;
-            double velz1 = currentIn.v[2] + coef1 * currentIn.Ez;
+            accelerateChunk_(particles, emFields, interpolator, mass);
+            return;
+        }
 
+        parallelForChunks(nbrParticles, nbrChunks,
+                          [&](std::size_t first, std::size_t last, std::size_t) {
+                              ParticleRange chunk{particles.begin() + first,
+                                                  particles.begin() + last};
+                              Interpolator chunkInterpolator{interpolator};
+                              accelerateChunk_(chunk, emFields, chunkInterpolator, mass);
+                          });
+    }
 
-            // preparing variables for magnetic rotation
-            double const rx = coef1 * currentIn.Bx;
-            double const ry = coef1 * currentIn.By;
-            double const rz = coef1 * currentIn.Bz;
 
-            double const rx2  = rx * rx;
-            double const ry2  = ry * ry;
-            double const rz2  = rz * rz;
-            double const rxry = rx * ry;
-            double const rxrz = rx * rz;
-            double const ryrz = ry * rz;
 
-            double const invDet = 1. / (1. + rx2 + ry2 + rz2);
 
-            // preparing rotation matrix due to the magnetic field
-            // m = invDet*(I + r*r - r x I) - I where x denotes the cross product
-            double const mxx = 1. + rx2 - ry2 - rz2;
-            double const mxy = 2. * (rxry + rz);
-            double const mxz = 2. * (rxrz - ry);
+    template<typename ParticleRangeT>
+    void accelerateChunk_(ParticleRangeT& particles, Electromag const& emFields,
+                          Interpolator& interpolator, double mass)
+    {
+        double dto2m = 0.5 * dt_ / mass;
 
-            double const myx = 2. * (rxry - rz);
-            double const myy = 1. + ry2 - rx2 - rz2;
-            double const myz = 2. * (ryrz + rx);
+        if constexpr (!fusedInterpolation)
+        {
+            // get electromagnetic fields interpolated on the particles of the range
+            interpolator(particles.begin(), particles.end(), emFields);
+        }
 
-            double const mzx = 2. * (rxrz + ry);
-            double const mzy = 2. * (ryrz - rx);
-            double const mzz = 1. + rz2 - rx2 - ry2;
+        BorisBatch batch;
 
-            // magnetic rotation
-            double const velx2 = (mxx * velx1 + mxy * vely1 + mxz * velz1) * invDet;
-            double const vely2 = (myx * velx1 + myy * vely1 + myz * velz1) * invDet;
-            double const velz2 = (mzx * velx1 + mzy * vely1 + mzz * velz1) * invDet;
+        auto current = particles.begin();
+        auto end     = particles.end();
 
+        while (current != end)
+        {
+            auto batchBegin   = current;
+            std::size_t count = 0;
 
-            // 2nd half push of the electric field
-            velx1 = velx2 + coef1 * currentIn.Ex;
-            vely1 = vely2 + coef1 * currentIn.Ey;
-            velz1 = velz2 + coef1 * currentIn.Ez;
+            for (; current != end && count < BorisBatch::size; ++current, ++count)
+            {
+                auto&& particle = *current;
+
+                if constexpr (fusedInterpolation)
+                {
+                    batch.set(count, particle.v, interpolator(particle, emFields),
+                              particle.charge * dto2m);
+                }
+                else
+                {
+                    batch.set(count, particle.v, particle, particle.charge * dto2m);
+                }
+            }
 
-            // Update particle velocity
-            currentOut->v[0] = velx1;
-            currentOut->v[1] = vely1;
-            currentOut->v[2] = velz1;
+            borisVelocityBatch(batch, count);
 
-            ++currentOut;
+            for (std::size_t i = 0; i < count; ++i, ++batchBegin)
+            {
+                (*batchBegin).v = batch.velocity(i);
+            }
         }
     }
 
 
 
 
+    //! below this number of particles per thread, pushing is not worth spawning threads
+    static constexpr std::size_t minParticlesPerThread_ = 4096;
+
     std::array<double, dim> halfDtOverDl_;
     double dt_;
+    std::size_t nbrThreads_;
+
+    //! leaving particles given to the BoundaryCondition, kept to reuse their storage
+    std::vector<Particle<dim>> leaving_;
 };
 
 
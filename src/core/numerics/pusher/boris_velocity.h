@@ -0,0 +1,232 @@
+#ifndef PHARE_CORE_NUMERICS_PUSHER_BORIS_VELOCITY_H
+#define PHARE_CORE_NUMERICS_PUSHER_BORIS_VELOCITY_H
+
+#include <array>
+#include <cstddef>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace PHARE
+{
+/** borisRotation applies the 3 steps of the Boris pusher (half push of the electric
+ * field, magnetic rotation, half push of the electric field) to the velocity (vx, vy, vz).
+ *
+ * coef1 is charge*dt/(2*mass). Real is either double, or one of the SIMD packs below
+ * so that the exact same sequence of operations is used by the scalar and vector paths.
+ */
+template<typename Real>
+inline void borisRotation(Real& vx, Real& vy, Real& vz, Real const& Ex, Real const& Ey,
+                          Real const& Ez, Real const& Bx, Real const& By, Real const& Bz,
+                          Real const& coef1)
+{
+    Real const one{1.};
+    Real const two{2.};
+
+    // 1st half push of the electric field
+    Real velx1 = vx + coef1 * Ex;
+    Real vely1 = vy + coef1 * Ey;
+    Real velz1 = vz + coef1 * Ez;
+
+
+    // preparing variables for magnetic rotation
+    Real const rx = coef1 * Bx;
+    Real const ry = coef1 * By;
+    Real const rz = coef1 * Bz;
+
+    Real const rx2  = rx * rx;
+    Real const ry2  = ry * ry;
+    Real const rz2  = rz * rz;
+    Real const rxry = rx * ry;
+    Real const rxrz = rx * rz;
+    Real const ryrz = ry * rz;
+
+    Real const invDet = one / (one + rx2 + ry2 + rz2);
+
+    // preparing rotation matrix due to the magnetic field
+    // m = invDet*(I + r*r - r x I) - I where x denotes the cross product
+    Real const mxx = one + rx2 - ry2 - rz2;
+    Real const mxy = two * (rxry + rz);
+    Real const mxz = two * (rxrz - ry);
+
+    Real const myx = two * (rxry - rz);
+    Real const myy = one + ry2 - rx2 - rz2;
+    Real const myz = two * (ryrz + rx);
+
+    Real const mzx = two * (rxrz + ry);
+    Real const mzy = two * (ryrz - rx);
+    Real const mzz = one + rz2 - rx2 - ry2;
+
+    // magnetic rotation
+    Real const velx2 = (mxx * velx1 + mxy * vely1 + mxz * velz1) * invDet;
+    Real const vely2 = (myx * velx1 + myy * vely1 + myz * velz1) * invDet;
+    Real const velz2 = (mzx * velx1 + mzy * vely1 + mzz * velz1) * invDet;
+
+
+    // 2nd half push of the electric field
+    vx = velx2 + coef1 * Ex;
+    vy = vely2 + coef1 * Ey;
+    vz = velz2 + coef1 * Ez;
+}
+
+
+
+/** return the velocity v updated by the Boris pusher given the fields (Ex..Bz members)
+ * seen by the particle and coef1 = charge*dt/(2*mass)
+ */
+template<typename Fields>
+inline std::array<double, 3> borisVelocity(std::array<double, 3> const& v, Fields const& fields,
+                                           double coef1)
+{
+    std::array<double, 3> newV = v;
+    borisRotation(newV[0], newV[1], newV[2], fields.Ex, fields.Ey, fields.Ez, fields.Bx, fields.By,
+                  fields.Bz, coef1);
+    return newV;
+}
+
+
+
+
+#if defined(__AVX512F__)
+
+//! 8 doubles processed at once with AVX-512
+struct SimdPack
+{
+    static constexpr std::size_t size = 8;
+    __m512d value;
+
+    SimdPack() = default;
+    SimdPack(__m512d v)
+        : value{v}
+    {
+    }
+    explicit SimdPack(double x)
+        : value{_mm512_set1_pd(x)}
+    {
+    }
+
+    static SimdPack load(double const* p) { return _mm512_load_pd(p); }
+    void store(double* p) const { _mm512_store_pd(p, value); }
+
+    friend SimdPack operator+(SimdPack a, SimdPack b) { return _mm512_add_pd(a.value, b.value); }
+    friend SimdPack operator-(SimdPack a, SimdPack b) { return _mm512_sub_pd(a.value, b.value); }
+    friend SimdPack operator*(SimdPack a, SimdPack b) { return _mm512_mul_pd(a.value, b.value); }
+    friend SimdPack operator/(SimdPack a, SimdPack b) { return _mm512_div_pd(a.value, b.value); }
+};
+
+#elif defined(__AVX2__)
+
+//! 4 doubles processed at once with AVX2
+struct SimdPack
+{
+    static constexpr std::size_t size = 4;
+    __m256d value;
+
+    SimdPack() = default;
+    SimdPack(__m256d v)
+        : value{v}
+    {
+    }
+    explicit SimdPack(double x)
+        : value{_mm256_set1_pd(x)}
+    {
+    }
+
+    static SimdPack load(double const* p) { return _mm256_load_pd(p); }
+    void store(double* p) const { _mm256_store_pd(p, value); }
+
+    friend SimdPack operator+(SimdPack a, SimdPack b) { return _mm256_add_pd(a.value, b.value); }
+    friend SimdPack operator-(SimdPack a, SimdPack b) { return _mm256_sub_pd(a.value, b.value); }
+    friend SimdPack operator*(SimdPack a, SimdPack b) { return _mm256_mul_pd(a.value, b.value); }
+    friend SimdPack operator/(SimdPack a, SimdPack b) { return _mm256_div_pd(a.value, b.value); }
+};
+
+#endif
+
+
+
+
+/** BorisBatch holds the velocities, fields and coefficients of a batch of particles
+ * in separate aligned arrays, so that their velocities can be updated with SIMD
+ * instructions by borisVelocityBatch().
+ */
+struct BorisBatch
+{
+    static constexpr std::size_t size = 8;
+
+    alignas(64) std::array<double, size> vx;
+    alignas(64) std::array<double, size> vy;
+    alignas(64) std::array<double, size> vz;
+    alignas(64) std::array<double, size> Ex;
+    alignas(64) std::array<double, size> Ey;
+    alignas(64) std::array<double, size> Ez;
+    alignas(64) std::array<double, size> Bx;
+    alignas(64) std::array<double, size> By;
+    alignas(64) std::array<double, size> Bz;
+    alignas(64) std::array<double, size> coef;
+
+
+    //! put the velocity, fields and coefficient of a particle at index i in the batch
+    template<typename Fields>
+    void set(std::size_t i, std::array<double, 3> const& v, Fields const& fields, double coef1)
+    {
+        vx[i]   = v[0];
+        vy[i]   = v[1];
+        vz[i]   = v[2];
+        Ex[i]   = fields.Ex;
+        Ey[i]   = fields.Ey;
+        Ez[i]   = fields.Ez;
+        Bx[i]   = fields.Bx;
+        By[i]   = fields.By;
+        Bz[i]   = fields.Bz;
+        coef[i] = coef1;
+    }
+
+    std::array<double, 3> velocity(std::size_t i) const { return {{vx[i], vy[i], vz[i]}}; }
+};
+
+
+
+
+/** update the velocities of the first 'count' particles of the batch.
+ *
+ * Particles are processed SimdPack::size at a time if AVX-512 or AVX2 is enabled at compile
+ * time, and the remaining ones (or all of them if no SIMD is available) with the scalar path.
+ */
+inline void borisVelocityBatch(BorisBatch& batch, std::size_t count)
+{
+    std::size_t i = 0;
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+    static_assert(BorisBatch::size % SimdPack::size == 0, "batch must hold whole SIMD packs");
+
+    for (; i + SimdPack::size <= count; i += SimdPack::size)
+    {
+        auto vx = SimdPack::load(&batch.vx[i]);
+        auto vy = SimdPack::load(&batch.vy[i]);
+        auto vz = SimdPack::load(&batch.vz[i]);
+
+        borisRotation(vx, vy, vz, SimdPack::load(&batch.Ex[i]), SimdPack::load(&batch.Ey[i]),
+                      SimdPack::load(&batch.Ez[i]), SimdPack::load(&batch.Bx[i]),
+                      SimdPack::load(&batch.By[i]), SimdPack::load(&batch.Bz[i]),
+                      SimdPack::load(&batch.coef[i]));
+
+        vx.store(&batch.vx[i]);
+        vy.store(&batch.vy[i]);
+        vz.store(&batch.vz[i]);
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        borisRotation(batch.vx[i], batch.vy[i], batch.vz[i], batch.Ex[i], batch.Ey[i], batch.Ez[i],
+                      batch.Bx[i], batch.By[i], batch.Bz[i], batch.coef[i]);
+    }
+}
+
+
+
+} // namespace PHARE
+
+#endif
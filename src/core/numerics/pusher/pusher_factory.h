@@ -2,8 +2,9 @@
 #define PHARE_CORE_NUMERIC_PUSHER_PUSHER_FACTORY_H
 
 #include <cstddef>
-#include <string>
 #include <memory>
+#include <stdexcept>
+#include <string>
 
 #include "pusher.h"
 #include "boris.h"
@@ -14,19 +15,34 @@ namespace PHARE
 class PusherFactory
 {
 public:
+    /** makePusher returns a pusher given its name:
+     * - "boris" : Boris pusher interpolating fields on all particles before accelerating them
+     * - "boris_fused" : Boris pusher interpolating fields and accelerating particle by particle
+     *
+     * nbrThreads is the number of threads used by the pusher to push particles.
+     */
     template<std::size_t dim, typename ParticleIterator, typename Electromag, typename Interpolator,
              typename ParticleSelector, typename BoundaryCondition>
-    static auto makePusher(std::string pusherName)
+    static std::unique_ptr<Pusher<dim, ParticleIterator, Electromag, Interpolator,
+                                  ParticleSelector, BoundaryCondition>>
+    makePusher(std::string pusherName, std::size_t nbrThreads = 1)
     {
         if (pusherName == "boris")
         {
             return std::make_unique<BorisPusher<dim, ParticleIterator, Electromag, Interpolator,
-                    ParticleSelector, BoundaryCondition>>();
+                    ParticleSelector, BoundaryCondition>>(nbrThreads);
+        }
+
+        else if (pusherName == "boris_fused")
+        {
+            return std::make_unique<BorisPusher<dim, ParticleIterator, Electromag, Interpolator,
+                                                ParticleSelector, BoundaryCondition, true>>(
+                nbrThreads);
         }
 
         else
         {
-            std::runtime_error("Error : Invalid Pusher name");
+            throw std::runtime_error("Error : Invalid Pusher name");
         }
     }
 };
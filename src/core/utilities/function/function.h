@@ -4,9 +4,17 @@
 #include <array>
 #include <cstddef>
 #include <functional>
+#include <vector>
 
 
 
+/** Function wraps the profile of a quantity, i.e. a function of the N coordinates.
+ *
+ * Besides the evaluation at a point, a Function can be evaluated at many points in one call,
+ * coordinates being given direction by direction. This batched evaluation uses the batch
+ * function given at construction, e.g. a vectorized or tabulated profile, and falls back to
+ * calling the point function at each point if there is none.
+ */
 template<typename R, std::size_t N>
 class Function
 {
@@ -17,14 +25,39 @@ template<typename R>
 class Function<R, 1>
 {
 public:
+    using batch_type = std::function<void(std::vector<double> const&, std::vector<R>&)>;
+
     explicit Function(std::function<R(double)> func)
         : f{func}
     {
     }
+
+    Function(std::function<R(double)> func, batch_type batchFunc)
+        : f{func}
+        , batch{batchFunc}
+    {
+    }
+
     R operator()(double x) { return f(x); }
 
+    //! values[i] is the value at x[i], values is resized to the number of points
+    void operator()(std::vector<double> const& x, std::vector<R>& values)
+    {
+        values.resize(x.size());
+        if (batch)
+        {
+            batch(x, values);
+            return;
+        }
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            values[i] = f(x[i]);
+        }
+    }
+
 private:
     std::function<R(double)> f;
+    batch_type batch;
 };
 
 
@@ -33,14 +66,41 @@ template<typename R>
 class Function<R, 2>
 {
 public:
+    using batch_type = std::function<void(std::vector<double> const&, std::vector<double> const&,
+                                          std::vector<R>&)>;
+
     explicit Function(std::function<R(double, double)> func)
         : f{func}
     {
     }
+
+    Function(std::function<R(double, double)> func, batch_type batchFunc)
+        : f{func}
+        , batch{batchFunc}
+    {
+    }
+
     R operator()(double x, double y) { return f(x, y); }
 
+    //! values[i] is the value at (x[i], y[i]), values is resized to the number of points
+    void operator()(std::vector<double> const& x, std::vector<double> const& y,
+                    std::vector<R>& values)
+    {
+        values.resize(x.size());
+        if (batch)
+        {
+            batch(x, y, values);
+            return;
+        }
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            values[i] = f(x[i], y[i]);
+        }
+    }
+
 private:
     std::function<R(double, double)> f;
+    batch_type batch;
 };
 
 
@@ -48,14 +108,41 @@ template<typename R>
 class Function<R, 3>
 {
 public:
+    using batch_type = std::function<void(std::vector<double> const&, std::vector<double> const&,
+                                          std::vector<double> const&, std::vector<R>&)>;
+
     explicit Function(std::function<R(double, double, double)> func)
         : f{func}
     {
     }
+
+    Function(std::function<R(double, double, double)> func, batch_type batchFunc)
+        : f{func}
+        , batch{batchFunc}
+    {
+    }
+
     R operator()(double x, double y, double z) { return f(x, y, z); }
 
+    //! values[i] is the value at (x[i], y[i], z[i]), values is resized to the number of points
+    void operator()(std::vector<double> const& x, std::vector<double> const& y,
+                    std::vector<double> const& z, std::vector<R>& values)
+    {
+        values.resize(x.size());
+        if (batch)
+        {
+            batch(x, y, z, values);
+            return;
+        }
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            values[i] = f(x[i], y[i], z[i]);
+        }
+    }
+
 private:
     std::function<R(double, double, double)> f;
+    batch_type batch;
 };
 
 
@@ -0,0 +1,55 @@
+#ifndef PHARE_CORE_UTILITIES_PARALLEL_PARALLEL_FOR_H
+#define PHARE_CORE_UTILITIES_PARALLEL_PARALLEL_FOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+#include "utilities/parallel/thread_pool.h"
+
+namespace PHARE
+{
+/** @brief chunkBounds returns the [first, last[ indexes of the chunk iChunk obtained
+ * when splitting [0, size[ in nbrChunks contiguous chunks of (almost) equal sizes.
+ */
+inline std::pair<std::size_t, std::size_t> chunkBounds(std::size_t size, std::size_t nbrChunks,
+                                                       std::size_t iChunk)
+{
+    auto const chunkSize = size / nbrChunks;
+    auto const remainder = size % nbrChunks;
+
+    auto const first = iChunk * chunkSize + std::min(iChunk, remainder);
+    auto const last  = first + chunkSize + (iChunk < remainder ? 1 : 0);
+
+    return {first, last};
+}
+
+
+
+
+/** @brief parallelForChunks splits [0, size[ in nbrChunks contiguous chunks, as given
+ * by chunkBounds(), and calls fn(first, last, iChunk) on each of them concurrently on the
+ * threads of ThreadPool::shared(), the calling thread taking chunks too. Threads are started
+ * by the first calls and reused by the following ones.
+ *
+ * The first exception thrown by fn, if any, is rethrown once all chunks are done.
+ */
+template<typename Fn>
+void parallelForChunks(std::size_t size, std::size_t nbrChunks, Fn&& fn)
+{
+    if (nbrChunks <= 1)
+    {
+        fn(std::size_t{0}, size, std::size_t{0});
+        return;
+    }
+
+    ThreadPool::shared().run(nbrChunks, [&](std::size_t iChunk) {
+        auto const bounds = chunkBounds(size, nbrChunks, iChunk);
+        fn(bounds.first, bounds.second, iChunk);
+    });
+}
+
+
+} // namespace PHARE
+
+#endif
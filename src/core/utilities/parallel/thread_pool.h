@@ -0,0 +1,222 @@
+#ifndef PHARE_CORE_UTILITIES_PARALLEL_THREAD_POOL_H
+#define PHARE_CORE_UTILITIES_PARALLEL_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace PHARE
+{
+/** @brief ThreadPool runs the chunks of parallel loops on worker threads that are started
+ * once and then wait for work, so that a loop does not pay for starting and joining threads.
+ *
+ * A loop is a job of nbrChunks chunks, queued until all its chunks are taken. Workers and
+ * the thread calling run() take the chunks one by one, and run() returns once all of them
+ * are done. Since the calling thread takes chunks too, a loop always progresses, even when
+ * all workers are busy, e.g. with another loop or when run() is called from a chunk.
+ *
+ * Workers are added when a loop has more chunks than there are threads to take them, so
+ * that the pool grows to the largest number of threads asked for, and no further.
+ *
+ * The first exception thrown by a chunk, in chunk order, is rethrown by run() once all
+ * chunks are done.
+ */
+class ThreadPool
+{
+public:
+    ThreadPool() = default;
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool(ThreadPool&&)      = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            stop_ = true;
+        }
+        workAvailable_.notify_all();
+
+        for (auto& worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+
+
+    //! the pool used by parallelForChunks(), started on first use and joined at exit
+    static ThreadPool& shared()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+
+
+    std::size_t nbrWorkers() const
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        return workers_.size();
+    }
+
+
+
+    //! call runChunk(iChunk) for iChunk in [0, nbrChunks[, and return once all calls are done
+    void run(std::size_t nbrChunks, std::function<void(std::size_t)> runChunk)
+    {
+        if (nbrChunks == 0)
+        {
+            return;
+        }
+
+        auto job = std::make_shared<Job>(nbrChunks, std::move(runChunk));
+
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            while (workers_.size() < nbrChunks - 1)
+            {
+                workers_.emplace_back([this] { work_(); });
+            }
+            jobs_.push_back(job);
+        }
+        workAvailable_.notify_all();
+
+        std::size_t iChunk;
+        while (takeChunk_(*job, iChunk))
+        {
+            runChunk_(*job, iChunk);
+        }
+
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+            job->done.wait(lock, [&job] { return job->nbrDone == job->nbrChunks; });
+        }
+
+        for (auto const& error : job->errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+
+
+private:
+    struct Job
+    {
+        Job(std::size_t nbrChunks_, std::function<void(std::size_t)> runChunk_)
+            : nbrChunks{nbrChunks_}
+            , runChunk{std::move(runChunk_)}
+            , errors(nbrChunks_)
+        {
+        }
+
+        std::size_t nbrChunks;
+        std::function<void(std::size_t)> runChunk;
+
+        // written by the thread running the chunk, read once all chunks are done
+        std::vector<std::exception_ptr> errors;
+
+        // guarded by mutex_
+        std::size_t nbrTaken = 0;
+        std::size_t nbrDone  = 0;
+        std::condition_variable done;
+    };
+
+
+    mutable std::mutex mutex_;
+    std::condition_variable workAvailable_;
+    std::deque<std::shared_ptr<Job>> jobs_;
+    std::vector<std::thread> workers_;
+    bool stop_ = false;
+
+
+
+    void work_()
+    {
+        while (true)
+        {
+            std::shared_ptr<Job> job;
+            std::size_t iChunk;
+            {
+                std::unique_lock<std::mutex> lock{mutex_};
+                workAvailable_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+                if (stop_)
+                {
+                    return;
+                }
+
+                job    = jobs_.front();
+                iChunk = job->nbrTaken++;
+                popTakenJobs_();
+            }
+
+            runChunk_(*job, iChunk);
+        }
+    }
+
+
+
+    //! take the next chunk of job, if any is left
+    bool takeChunk_(Job& job, std::size_t& iChunk)
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (job.nbrTaken == job.nbrChunks)
+        {
+            return false;
+        }
+
+        iChunk = job.nbrTaken++;
+        popTakenJobs_();
+        return true;
+    }
+
+
+
+    //! remove from the queue the jobs whose chunks are all taken, mutex_ being held
+    void popTakenJobs_()
+    {
+        while (!jobs_.empty() && jobs_.front()->nbrTaken == jobs_.front()->nbrChunks)
+        {
+            jobs_.pop_front();
+        }
+    }
+
+
+
+    void runChunk_(Job& job, std::size_t iChunk)
+    {
+        try
+        {
+            job.runChunk(iChunk);
+        }
+        catch (...)
+        {
+            job.errors[iChunk] = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (++job.nbrDone == job.nbrChunks)
+        {
+            job.done.notify_all();
+        }
+    }
+};
+
+
+} // namespace PHARE
+
+#endif
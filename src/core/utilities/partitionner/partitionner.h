@@ -1,8 +1,12 @@
 #ifndef PHARE_CORE_UTILITIES_PARTITIONNER_PARTITIONNER_H
 #define PHARE_CORE_UTILITIES_PARTITIONNER_PARTITIONNER_H
 
+#include <cstddef>
+#include <iterator>
+#include <utility>
 #include <vector>
 
+#include "utilities/box/box.h"
 #include "utilities/meta/meta_utilities.h"
 #include "utilities/particle_selector/particle_selector.h"
 
@@ -27,18 +31,76 @@ namespace PHARE
  * [begin, end[ are leaving particles, some are in physical boundary boxes, some
  * are leaving the patch but not through physical boundaries.
  *
+ * Particles found in several boxes go with the first of them. Rather than partitioning
+ * the range again for each box, the range is traversed once to find the box of each
+ * particle, and each swap then puts at least one particle in its final bucket.
+ * ParticleIterator must be a random access iterator.
  */
 template<typename ParticleIterator, typename BoxContainer, is_iterable<BoxContainer> = dummy::value>
 auto partitionner(ParticleIterator begin, ParticleIterator end, BoxContainer boxes)
 {
-    std::vector<ParticleIterator> iterators;
-    iterators.push_back(begin);
-    auto pivot = begin;
+    // the partition is done in one pass over the range: each particle is given the index
+    // of the first box it is in (or the number of boxes if none), particles are counted
+    // per box and then swapped directly into the bucket of their box.
+    auto const nbrBoxes     = static_cast<std::size_t>(boxes.size());
+    auto const nbrBuckets   = nbrBoxes + 1;
+    auto const nbrParticles = static_cast<std::size_t>(std::distance(begin, end));
+
+    std::vector<std::size_t> boxIndexes(nbrParticles);
+    std::vector<std::size_t> bucketStart(nbrBuckets + 1, 0);
+
+    std::size_t iPart = 0;
+    for (auto particle = begin; particle != end; ++particle, ++iPart)
+    {
+        auto const cell = cellAsPoint(*particle);
 
-    for (auto const& box : boxes)
+        std::size_t iBox = 0;
+        for (auto const& box : boxes)
+        {
+            if (isIn(cell, box))
+            {
+                break;
+            }
+            ++iBox;
+        }
+        boxIndexes[iPart] = iBox;
+        ++bucketStart[iBox + 1];
+    }
+
+    // bucket iBucket will span [bucketStart[iBucket], bucketStart[iBucket + 1][
+    for (std::size_t iBucket = 0; iBucket < nbrBuckets; ++iBucket)
+    {
+        bucketStart[iBucket + 1] += bucketStart[iBucket];
+    }
+
+    // next free position of each bucket, particles before it are in the right bucket
+    std::vector<std::size_t> next(std::begin(bucketStart), std::end(bucketStart) - 1);
+
+    using std::swap;
+    for (std::size_t iBucket = 0; iBucket < nbrBuckets; ++iBucket)
+    {
+        while (next[iBucket] < bucketStart[iBucket + 1])
+        {
+            auto const current = next[iBucket];
+            auto const target  = boxIndexes[current];
+
+            if (target == iBucket)
+            {
+                ++next[iBucket];
+            }
+            else
+            {
+                auto const destination = next[target]++;
+                swap(*(begin + current), *(begin + destination));
+                swap(boxIndexes[current], boxIndexes[destination]);
+            }
+        }
+    }
+
+    std::vector<ParticleIterator> iterators;
+    for (std::size_t iBucket = 0; iBucket < nbrBuckets; ++iBucket)
     {
-        pivot = std::partition(pivot, end, makeSelector(box));
-        iterators.push_back(pivot);
+        iterators.push_back(begin + bucketStart[iBucket]);
     }
 
     return iterators;
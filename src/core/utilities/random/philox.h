@@ -0,0 +1,108 @@
+#ifndef PHARE_CORE_UTILITIES_RANDOM_PHILOX_H
+#define PHARE_CORE_UTILITIES_RANDOM_PHILOX_H
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace PHARE
+{
+/** @brief Philox4x32 is the Philox4x32-10 counter-based random number generator of
+ * Salmon et al., "Parallel random numbers: as easy as 1, 2, 3" (SC'11).
+ *
+ * It has no state: it maps a 128 bits counter and a 64 bits key to 128 random bits. Giving
+ * each random draw its own counter, e.g. made of a cell index and a particle index, lets
+ * draws be made in any order and by any thread, and always give the same numbers.
+ */
+class Philox4x32
+{
+public:
+    using counter_type = std::array<std::uint32_t, 4>;
+    using key_type     = std::array<std::uint32_t, 2>;
+
+
+    explicit Philox4x32(key_type key)
+        : key_{key}
+    {
+    }
+
+    explicit Philox4x32(std::uint64_t seed)
+        : key_{{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)}}
+    {
+    }
+
+
+    counter_type operator()(counter_type counter) const
+    {
+        auto key = key_;
+        for (int round = 0; round < nbrRounds_; ++round)
+        {
+            counter = round_(counter, key);
+            key[0] += weyl0_;
+            key[1] += weyl1_;
+        }
+        return counter;
+    }
+
+
+private:
+    static constexpr int nbrRounds_ = 10;
+
+    static constexpr std::uint32_t multiplier0_ = 0xD2511F53;
+    static constexpr std::uint32_t multiplier1_ = 0xCD9E8D57;
+    static constexpr std::uint32_t weyl0_       = 0x9E3779B9;
+    static constexpr std::uint32_t weyl1_       = 0xBB67AE85;
+
+    key_type key_;
+
+
+    static counter_type round_(counter_type const& counter, key_type const& key)
+    {
+        auto const product0 = static_cast<std::uint64_t>(multiplier0_) * counter[0];
+        auto const product1 = static_cast<std::uint64_t>(multiplier1_) * counter[2];
+
+        auto const hi0 = static_cast<std::uint32_t>(product0 >> 32);
+        auto const lo0 = static_cast<std::uint32_t>(product0);
+        auto const hi1 = static_cast<std::uint32_t>(product1 >> 32);
+        auto const lo1 = static_cast<std::uint32_t>(product1);
+
+        return {{hi1 ^ counter[1] ^ key[0], lo1, hi0 ^ counter[3] ^ key[1], lo0}};
+    }
+};
+
+
+
+
+//! uniform double in [0, 1[ made of the 53 upper bits of (hi, lo)
+inline double uniformDouble(std::uint32_t hi, std::uint32_t lo)
+{
+    auto const bits = ((static_cast<std::uint64_t>(hi) << 32) | lo) >> 11;
+    return static_cast<double>(bits) * 0x1p-53;
+}
+
+
+//! uniform float in [0, 1[ made of the 24 upper bits of word
+inline float uniformFloat(std::uint32_t word)
+{
+    return static_cast<float>(word >> 8) * 0x1p-24f;
+}
+
+
+
+
+/** @brief boxMuller turns two uniform numbers u1 in ]0, 1] and u2 in [0, 1[ into two
+ * independent normal numbers of zero mean and unit variance
+ */
+inline std::array<double, 2> boxMuller(double u1, double u2)
+{
+    constexpr double twoPi = 6.283185307179586476925286766559;
+
+    auto const radius = std::sqrt(-2. * std::log(u1));
+    auto const angle  = twoPi * u2;
+    return {{radius * std::cos(angle), radius * std::sin(angle)}};
+}
+
+
+} // namespace PHARE
+
+#endif
@@ -17,6 +17,10 @@ using int64  = std::int64_t;
 
 enum class Basis { Magnetic, Cartesian };
 
+/** Uniform loads the same number of particles in every cell, Density loads a number of
+ * particles proportional to the density of the cell */
+enum class ParticleCount { Uniform, Density };
+
 
 
 
@@ -0,0 +1,94 @@
+#ifndef PHARE_TEST_BOX_COARSEN_H
+#define PHARE_TEST_BOX_COARSEN_H
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+#include <SAMRAI/hier/Box.h>
+#include <SAMRAI/hier/IntVector.h>
+
+#include "data/field/coarsening/field_coarsen.h"
+#include "data/field/field.h"
+#include "data/grid/gridlayoutdefs.h"
+#include "data/ndarray/ndarray_vector.h"
+#include "hybrid/hybrid_quantities.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using namespace PHARE;
+
+
+/** @brief ABoxCoarsen checks that coarsening a whole box gives the same values as coarsening
+ * each of its indexes, for the ratios that have a compile time specialization (2 and 4) and
+ * one that does not (3), and for all centerings.
+ */
+struct ABoxCoarsen : public testing::TestWithParam<int>
+{
+    static constexpr std::size_t dimension = 2;
+
+    using Field2D = Field<NdArrayVector2D<>, HybridQuantity::Scalar>;
+
+    SAMRAI::tbox::Dimension dim{dimension};
+    SAMRAI::hier::BlockId blockId{0};
+
+    int ratio{GetParam()};
+    uint32 nbrFineNodes{static_cast<uint32>(30 + 10 * GetParam())};
+
+    // the fine ghost box starts 10 fine nodes before the first coarse index refined
+    SAMRAI::hier::Box fineBox{SAMRAI::hier::Index{dim, 100 * GetParam() - 10},
+                              SAMRAI::hier::Index{dim, 100 * GetParam() + 20}, blockId};
+    SAMRAI::hier::Box coarseGhostBox{SAMRAI::hier::Index{dim, 90}, SAMRAI::hier::Index{dim, 120},
+                                     blockId};
+    SAMRAI::hier::Box coarseBox{SAMRAI::hier::Index{dim, 100}, SAMRAI::hier::Index{dim, 104},
+                                blockId};
+
+    Field2D fineField{"fine", HybridQuantity::Scalar::Ex, nbrFineNodes, nbrFineNodes};
+    Field2D pointwise{"pointwise", HybridQuantity::Scalar::Ex, 31u, 31u};
+    Field2D boxwise{"boxwise", HybridQuantity::Scalar::Ex, 31u, 31u};
+
+
+    ABoxCoarsen()
+    {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<double> value(-1., 1.);
+        std::generate(std::begin(fineField), std::end(fineField), [&]() { return value(gen); });
+    }
+};
+
+
+
+
+TEST_P(ABoxCoarsen, givesTheSameValuesAsCoarseningEachIndex)
+{
+    SAMRAI::hier::IntVector ratioVector{dim, ratio};
+
+    for (auto xCentering : {QtyCentering::primal, QtyCentering::dual})
+    {
+        for (auto yCentering : {QtyCentering::primal, QtyCentering::dual})
+        {
+            CoarsenField<dimension> coarsenIt{{{xCentering, yCentering}}, fineBox,
+                                              coarseGhostBox, ratioVector};
+
+            for (int ix = coarseBox.lower(dirX); ix <= coarseBox.upper(dirX); ++ix)
+            {
+                for (int iy = coarseBox.lower(dirY); iy <= coarseBox.upper(dirY); ++iy)
+                {
+                    coarsenIt(fineField, pointwise, Point<int, dimension>{ix, iy});
+                }
+            }
+
+            coarsenIt(fineField, boxwise, coarseBox);
+
+            EXPECT_TRUE(std::equal(std::begin(pointwise), std::end(pointwise),
+                                   std::begin(boxwise)));
+        }
+    }
+}
+
+
+INSTANTIATE_TEST_CASE_P(WithRatios, ABoxCoarsen, testing::Values(2, 3, 4));
+
+
+#endif
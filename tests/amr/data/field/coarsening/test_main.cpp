@@ -14,6 +14,7 @@
 
 
 #include "test_basic_hierarchy.h"
+#include "test_box_coarsen.h"
 #include "test_linear_coarsen.h"
 #include "test_weighter_coarsen.h"
 
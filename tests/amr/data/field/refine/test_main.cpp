@@ -398,6 +398,82 @@ TEST(AFieldLinearIndexesAndWeights1D, giveACorrectiWeightForDualOddRatio)
     EXPECT_THAT(iWeight, Eq(0));
 }
 
+TEST(AFieldLinearIndexesAndWeights1D, giveACorrectStartAndiWeightForNegativeIndexes)
+{
+    std::size_t constexpr dimension{1};
+
+    std::array<QtyCentering, dimension> centering{{QtyCentering::primal}};
+
+    SAMRAI::hier::IntVector ratio{SAMRAI::tbox::Dimension{dimension}, 2};
+
+    FieldLinearRefineIndexesAndWeights<dimension> indexesAndWeights{centering, ratio};
+
+    EXPECT_EQ(-1, indexesAndWeights.computeStartIndex(dirX, -1));
+    EXPECT_EQ(1, indexesAndWeights.computeWeightIndex(dirX, -1));
+    EXPECT_EQ(-1, indexesAndWeights.computeStartIndex(dirX, -2));
+    EXPECT_EQ(0, indexesAndWeights.computeWeightIndex(dirX, -2));
+}
+
+TEST(ALinearRefineWeightsTable, isComputedOncePerCenteringAndRatio)
+{
+    auto const& dualWeights = linearRefineWeights(QtyCentering::dual, 4);
+
+    EXPECT_EQ(&dualWeights, &linearRefineWeights(QtyCentering::dual, 4));
+    EXPECT_NE(&dualWeights, &linearRefineWeights(QtyCentering::primal, 4));
+    EXPECT_EQ(4u, dualWeights.size());
+}
+
+TEST(FieldLinearRefine, givesTheSameValuesOnABoxAsOnEachOfItsIndexes)
+{
+    constexpr std::size_t dimension{2};
+    using Field2D = Field<NdArrayVector2D<>, HybridQuantity::Scalar>;
+
+    SAMRAI::tbox::Dimension dim{dimension};
+    SAMRAI::hier::BlockId blockId{0};
+
+    SAMRAI::hier::IntVector ratio{dim, 2};
+
+    SAMRAI::hier::Box coarseGhostBox{SAMRAI::hier::Index{dim, 90}, SAMRAI::hier::Index{dim, 120},
+                                     blockId};
+    SAMRAI::hier::Box fineGhostBox{SAMRAI::hier::Index{dim, 197}, SAMRAI::hier::Index{dim, 230},
+                                   blockId};
+    SAMRAI::hier::Box fineBox{SAMRAI::hier::Index{dim, 199}, SAMRAI::hier::Index{dim, 210},
+                              blockId};
+
+    Field2D coarseField{"coarse", HybridQuantity::Scalar::Ex, 31u, 31u};
+    double value = 0.;
+    for (auto& coarseValue : coarseField)
+    {
+        coarseValue = value;
+        value += 0.37;
+    }
+
+    for (auto xCentering : {QtyCentering::primal, QtyCentering::dual})
+    {
+        for (auto yCentering : {QtyCentering::primal, QtyCentering::dual})
+        {
+            Field2D pointwise{"pointwise", HybridQuantity::Scalar::Ex, 34u, 34u};
+            Field2D boxwise{"boxwise", HybridQuantity::Scalar::Ex, 34u, 34u};
+
+            FieldLinearRefine<dimension> refineIt{
+                {{xCentering, yCentering}}, fineGhostBox, coarseGhostBox, ratio};
+
+            for (int ix = fineBox.lower(dirX); ix <= fineBox.upper(dirX); ++ix)
+            {
+                for (int iy = fineBox.lower(dirY); iy <= fineBox.upper(dirY); ++iy)
+                {
+                    refineIt(coarseField, pointwise, Point<int, dimension>{ix, iy});
+                }
+            }
+
+            refineIt(coarseField, boxwise, fineBox);
+
+            EXPECT_TRUE(
+                std::equal(std::begin(pointwise), std::end(pointwise), std::begin(boxwise)));
+        }
+    }
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <vector>
+
 #include "data/particles/particles_data.h"
 #include <SAMRAI/tbox/SAMRAIManager.h>
 #include <SAMRAI/tbox/SAMRAI_MPI.h>
@@ -126,6 +129,40 @@ TEST_F(AParticlesData1D, DoesNothingForParticleOutOfGhostRegionWhenCopying)
 
 
 
+TEST_F(AParticlesData1D, CopiesTheSameParticlesFromACellSortedSource)
+{
+    for (int iCell = 9; iCell >= 0; --iCell)
+    {
+        particle.iCell = {{iCell}};
+        sourceData.domainParticles.push_back(particle);
+        sourceData.ghostParticles.push_back(particle);
+    }
+
+    destData.copy(sourceData);
+
+    ParticlesData<1> sortedDestData{destDomain, ghost};
+    sourceData.sortByCell();
+    ASSERT_TRUE(sourceData.isSortedByCell());
+    sortedDestData.copy(sourceData);
+
+    auto cells = [](auto const& particles) {
+        std::vector<int> iCells;
+        for (auto const& part : particles)
+        {
+            iCells.push_back(part.iCell[0]);
+        }
+        std::sort(std::begin(iCells), std::end(iCells));
+        return iCells;
+    };
+
+    EXPECT_THAT(cells(sortedDestData.domainParticles), Eq(cells(destData.domainParticles)));
+    EXPECT_THAT(cells(sortedDestData.ghostParticles), Eq(cells(destData.ghostParticles)));
+    EXPECT_FALSE(sortedDestData.isSortedByCell());
+}
+
+
+
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -152,6 +152,44 @@ TEST_F(AParticlesData1D, PreserveChargeWhenCopyingWithPeriodics)
 
 
 
+TEST_F(AParticlesData1D, TransferMovesSourceParticlesLandingInDestDomainWithPeriodics)
+{
+    particle.iCell = {{6}};
+    sourcePdat.domainParticles.push_back(particle);
+
+    particle.iCell = {{7}};
+    sourcePdat.domainParticles.push_back(particle);
+
+    destPdat.transfer(sourcePdat, *cellOverlap);
+
+    ASSERT_THAT(destPdat.domainParticles.size(), Eq(1));
+    ASSERT_THAT(destPdat.ghostParticles.size(), Eq(0));
+    EXPECT_THAT(destPdat.domainParticles[0].iCell[0], Eq(1));
+
+    ASSERT_THAT(sourcePdat.domainParticles.size(), Eq(1));
+    EXPECT_THAT(sourcePdat.domainParticles[0].iCell[0], Eq(6));
+}
+
+
+
+
+TEST_F(AParticlesData1D, TransferHandsOverTheWholeSourceArrayWithPeriodics)
+{
+    particle.iCell = {{7}};
+    sourcePdat.domainParticles.push_back(particle);
+    sourcePdat.domainParticles.push_back(particle);
+
+    destPdat.transfer(sourcePdat, *cellOverlap);
+
+    ASSERT_THAT(destPdat.domainParticles.size(), Eq(2));
+    EXPECT_THAT(destPdat.domainParticles[1].iCell[0], Eq(1));
+    EXPECT_THAT(destPdat.domainParticles[1].weight, Eq(particle.weight));
+    EXPECT_TRUE(sourcePdat.domainParticles.empty());
+}
+
+
+
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -12,6 +12,8 @@
 #include "gtest/gtest.h"
 
 using testing::Eq;
+using testing::Gt;
+using testing::Lt;
 
 using namespace PHARE;
 
@@ -191,6 +193,142 @@ TEST_F(AParticlesData1D, PreserveChargeWhenPackingWithPeriodics)
 
 
 
+TEST_F(AParticlesData1D, UnpackEachParticleInItsBufferWithPeriodics)
+{
+    particle.iCell = {{6}};
+    sourceData.domainParticles.push_back(particle);
+
+    particle.iCell = {{7}};
+    sourceData.domainParticles.push_back(particle);
+    sourceData.domainParticles.push_back(particle);
+
+    SAMRAI::tbox::MessageStream particlesWriteStream;
+
+    sourceData.packStream(particlesWriteStream, *cellOverlap);
+
+    SAMRAI::tbox::MessageStream particlesReadStream{particlesWriteStream.getCurrentSize(),
+                                                    SAMRAI::tbox::MessageStream::Read,
+                                                    particlesWriteStream.getBufferStart()};
+
+    destData.unpackStream(particlesReadStream, *cellOverlap);
+
+    ASSERT_THAT(destData.ghostParticles.size(), Eq(1));
+    ASSERT_THAT(destData.domainParticles.size(), Eq(2));
+    EXPECT_THAT(destData.ghostParticles[0].iCell[0], Eq(0));
+    EXPECT_THAT(destData.domainParticles[0].iCell[0], Eq(1));
+}
+
+
+
+
+TEST_F(AParticlesData1D, GivesTheExactSizeOfThePackedStream)
+{
+    particle.iCell = {{6}};
+    sourceData.domainParticles.push_back(particle);
+    sourceData.domainParticles.push_back(particle);
+
+    SAMRAI::tbox::MessageStream particlesWriteStream;
+
+    sourceData.packStream(particlesWriteStream, *cellOverlap);
+
+    EXPECT_THAT(sourceData.getDataStreamSize(*cellOverlap),
+                Eq(particlesWriteStream.getCurrentSize()));
+}
+
+
+
+
+TEST_F(AParticlesData1D, UpdatesTheStreamSizeWhenParticlesChange)
+{
+    particle.iCell = {{6}};
+    sourceData.domainParticles.push_back(particle);
+
+    auto const sizeWithOneParticle = sourceData.getDataStreamSize(*cellOverlap);
+
+    sourceData.getPointer()->domainParticles->push_back(particle);
+
+    SAMRAI::tbox::MessageStream particlesWriteStream;
+
+    sourceData.packStream(particlesWriteStream, *cellOverlap);
+
+    EXPECT_THAT(sourceData.getDataStreamSize(*cellOverlap), Gt(sizeWithOneParticle));
+    EXPECT_THAT(sourceData.getDataStreamSize(*cellOverlap),
+                Eq(particlesWriteStream.getCurrentSize()));
+}
+
+
+
+
+TEST_F(AParticlesData1D, SelectsTheParticlesAgainForEachExchange)
+{
+    particle.iCell = {{6}};
+    sourceData.domainParticles.push_back(particle);
+
+    SAMRAI::tbox::MessageStream firstWriteStream;
+
+    sourceData.getDataStreamSize(*cellOverlap);
+    sourceData.packStream(firstWriteStream, *cellOverlap);
+
+    // the particle leaves the overlap in place, as during a push, without getPointer()
+    sourceData.domainParticles[0].iCell = {{3}};
+
+    auto const size = sourceData.getDataStreamSize(*cellOverlap);
+
+    SAMRAI::tbox::MessageStream secondWriteStream;
+
+    sourceData.packStream(secondWriteStream, *cellOverlap);
+
+    EXPECT_THAT(size, Lt(firstWriteStream.getCurrentSize()));
+    EXPECT_THAT(secondWriteStream.getCurrentSize(), Eq(size));
+
+    SAMRAI::tbox::MessageStream particlesReadStream{secondWriteStream.getCurrentSize(),
+                                                    SAMRAI::tbox::MessageStream::Read,
+                                                    secondWriteStream.getBufferStart()};
+
+    destData.unpackStream(particlesReadStream, *cellOverlap);
+
+    EXPECT_THAT(destData.ghostParticles.size(), Eq(0));
+    EXPECT_THAT(destData.domainParticles.size(), Eq(0));
+}
+
+
+
+
+TEST_F(AParticlesData1D, StreamsAnOutgoingBucketAsUnpackStreamReadsIt)
+{
+    // source domain cells 10 to 15 are local cells 1 to 6 of its ghost box starting at 9
+    OutgoingParticles<1> outgoing{Box<int, 1>{Point<int, 1>{1}, Point<int, 1>{6}}, {{9}}};
+
+    // the particle leaves the source through its upper side, on AMR cell 16, which is
+    // equivalent to the first domain cell of the destination with periodics
+    particle.iCell = {{7}};
+    outgoing.push_back(particle);
+
+    auto const& bucket = outgoing.bucket({{1}});
+
+    SAMRAI::tbox::MessageStream particlesWriteStream;
+
+    sourceData.packBucketStream(particlesWriteStream, bucket, transformation);
+
+    EXPECT_THAT(sourceData.getBucketStreamSize(bucket), Eq(particlesWriteStream.getCurrentSize()));
+
+    SAMRAI::tbox::MessageStream particlesReadStream{particlesWriteStream.getCurrentSize(),
+                                                    SAMRAI::tbox::MessageStream::Read,
+                                                    particlesWriteStream.getBufferStart()};
+
+    destData.unpackStream(particlesReadStream, *cellOverlap);
+
+    std::array<int, 1> expectediCell{1};
+
+    ASSERT_THAT(destData.domainParticles.size(), Eq(1));
+    EXPECT_THAT(destData.domainParticles[0].iCell, Eq(expectediCell));
+    EXPECT_THAT(destData.domainParticles[0].v, Eq(particle.v));
+    EXPECT_THAT(destData.ghostParticles.size(), Eq(0));
+}
+
+
+
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
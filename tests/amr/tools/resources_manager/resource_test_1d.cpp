@@ -2,6 +2,8 @@
 #include "resource_test_1d.h"
 #include "data/electromag/electromag.h"
 
+#include <new>
+
 struct GridLayoutMock
 {
 };
@@ -12,6 +14,30 @@ using Ions1D          = Ions<IonPopulation1D, GridLayoutMock>;
 using Electromag1D    = Electromag<VecField1D>;
 
 
+// a VecField1D counting the calls by which the ResourcesManager finds its resources by name
+struct CountingVecField1D : public VecField1D
+{
+    using VecField1D::VecField1D;
+
+    resources_properties getFieldNamesAndQuantities() const
+    {
+        ++nbrNameLookups;
+        return VecField1D::getFieldNamesAndQuantities();
+    }
+
+    void setBuffer(std::string const &bufferName, field_type *field)
+    {
+        ++nbrSetBufferCalls;
+        VecField1D::setBuffer(bufferName, field);
+    }
+
+    mutable int nbrNameLookups = 0;
+    int nbrSetBufferCalls      = 0;
+};
+
+
+
+
 struct IonPopulation1D_P
 {
     std::string name = "protons";
@@ -30,6 +56,16 @@ struct VecField1D_P
 
 
 
+struct CountingVecField1D_P
+{
+    std::string name = "B";
+    HybridQuantity::Vector qty{HybridQuantity::Vector::B};
+    CountingVecField1D user{name, qty};
+};
+
+
+
+
 struct Ions1D_P
 {
     IonsInitializer<ParticleArray<1>, GridLayoutMock> createInitializer()
@@ -64,6 +100,53 @@ struct Electromag1D_P
 
 
 
+// addresses of the resources a ResourcesUser is currently set on
+std::vector<void const *> resourcesAddresses(VecField1D const &vecField)
+{
+    return {&vecField.getComponent(Component::X), &vecField.getComponent(Component::Y),
+            &vecField.getComponent(Component::Z)};
+}
+
+
+std::vector<void const *> resourcesAddresses(IonPopulation1D &population)
+{
+    auto addresses = resourcesAddresses(population.flux());
+
+    addresses.push_back(&population.density());
+    addresses.push_back(&population.domainParticles());
+    addresses.push_back(&population.ghostParticles());
+    addresses.push_back(&population.coarseToFineParticles());
+    return addresses;
+}
+
+
+std::vector<void const *> resourcesAddresses(Ions1D &ions)
+{
+    auto addresses = resourcesAddresses(ions.velocity());
+
+    addresses.push_back(&ions.density());
+    for (auto &population : ions.getRunTimeResourcesUserList())
+    {
+        auto const populationAddresses = resourcesAddresses(population);
+        addresses.insert(std::end(addresses), std::begin(populationAddresses),
+                         std::end(populationAddresses));
+    }
+    return addresses;
+}
+
+
+std::vector<void const *> resourcesAddresses(Electromag1D const &electromag)
+{
+    auto addresses        = resourcesAddresses(electromag.E);
+    auto const bAddresses = resourcesAddresses(electromag.B);
+
+    addresses.insert(std::end(addresses), std::begin(bAddresses), std::end(bAddresses));
+    return addresses;
+}
+
+
+
+
 using IonPop1DOnly          = std::tuple<IonPopulation1D_P>;
 using VecField1DOnly        = std::tuple<VecField1D_P>;
 using Ions1DOnly            = std::tuple<Ions1D_P>;
@@ -102,8 +185,135 @@ TYPED_TEST_P(aResourceUserCollection, hasPointersValidOnlyWithGuard)
 
 
 
-REGISTER_TYPED_TEST_CASE_P(aResourceUserCollection, hasPointersValidOnlyWithGuard);
+TYPED_TEST_P(aResourceUserCollection, hasPointersSetPatchAfterPatchByALevelBinding)
+{
+    auto check = [this](auto &resourceUserPack) {
+        auto &hierarchy    = this->hierarchy->hierarchy;
+        auto &resourceUser = resourceUserPack.user;
+
+        for (int iLevel = 0; iLevel < hierarchy->getNumberOfLevels(); ++iLevel)
+        {
+            auto patchLevel = hierarchy->getPatchLevel(iLevel);
+            {
+                auto binding = this->resourcesManager.makeLevelBinding(patchLevel, resourceUser);
+                EXPECT_EQ(static_cast<std::size_t>(patchLevel->getLocalNumberOfPatches()),
+                          binding.size());
+                EXPECT_TRUE(binding.isValid());
+
+                for (std::size_t iPatch = 0; iPatch < binding.size(); ++iPatch)
+                {
+                    std::vector<void const *> guardAddresses;
+                    {
+                        auto guard = this->resourcesManager.makeResourcesGuard(
+                            binding.patch(iPatch), resourceUser);
+                        guardAddresses = resourcesAddresses(resourceUser);
+                    }
+
+                    binding.setOnPatch(iPatch);
+                    EXPECT_TRUE(resourceUser.isUsable());
+                    EXPECT_FALSE(resourceUser.isSettable());
+                    EXPECT_EQ(guardAddresses, resourcesAddresses(resourceUser));
+                }
+            }
+            EXPECT_FALSE(resourceUser.isUsable());
+            EXPECT_TRUE(resourceUser.isSettable());
+        }
+    };
+
+    std::apply(check, this->users);
+}
+
+
+
+REGISTER_TYPED_TEST_CASE_P(aResourceUserCollection, hasPointersValidOnlyWithGuard,
+                           hasPointersSetPatchAfterPatchByALevelBinding);
 
 
 typedef ::testing::Types<IonPop1DOnly, VecField1DOnly, Ions1DOnly, Electromag1DOnly> MyTypes;
 INSTANTIATE_TYPED_TEST_CASE_P(testResourcesManager, aResourceUserCollection, MyTypes);
+
+
+
+
+using aRegisteredVecField = aResourceUserCollection<VecField1DOnly>;
+
+TEST_F(aRegisteredVecField, isNotConfusedWithAnotherUserBuiltAtItsAddress)
+{
+    auto patchLevel = hierarchy->hierarchy->getPatchLevel(0);
+
+    VecField1D electric{"E", HybridQuantity::Vector::E};
+    resourcesManager.registerResources(electric);
+    for (auto &patch : *patchLevel)
+    {
+        resourcesManager.allocate(electric, *patch);
+    }
+
+    // the registered "B" user is replaced, at the same address, by a user of "E"
+    auto &registered = std::get<0>(users).user;
+    registered.~VecField1D();
+    auto *replacement = new (&registered) VecField1D{"E", HybridQuantity::Vector::E};
+
+    for (auto const &patch : *patchLevel)
+    {
+        std::vector<void const *> electricAddresses;
+        {
+            auto guard        = resourcesManager.makeResourcesGuard(*patch, electric);
+            electricAddresses = resourcesAddresses(electric);
+        }
+
+        auto guard = resourcesManager.makeResourcesGuard(*patch, *replacement);
+        EXPECT_EQ(electricAddresses, resourcesAddresses(*replacement));
+    }
+}
+
+
+
+
+using aCountingVecField = aResourceUserCollection<std::tuple<CountingVecField1D_P>>;
+
+TEST_F(aCountingVecField, isSetByGuardsFromItsBoundHandlesWithoutItsNames)
+{
+    auto &registered = std::get<0>(users).user;
+    auto patchLevel  = hierarchy->hierarchy->getPatchLevel(0);
+
+    registered.nbrNameLookups    = 0;
+    registered.nbrSetBufferCalls = 0;
+    for (auto const &patch : *patchLevel)
+    {
+        auto guard = resourcesManager.makeResourcesGuard(*patch, registered);
+        EXPECT_TRUE(registered.isUsable());
+    }
+    EXPECT_TRUE(registered.isSettable());
+    EXPECT_EQ(0, registered.nbrNameLookups);
+    EXPECT_EQ(0, registered.nbrSetBufferCalls);
+
+    // a moved user has the handle of the registered one, but not its address
+    CountingVecField1D moved{std::move(registered)};
+    for (auto const &patch : *patchLevel)
+    {
+        auto guard = resourcesManager.makeResourcesGuard(*patch, moved);
+        EXPECT_TRUE(moved.isUsable());
+    }
+    EXPECT_LT(0, moved.nbrNameLookups);
+}
+
+
+
+TEST_F(aCountingVecField, isSetPatchAfterPatchByALevelBindingWithoutSetBuffer)
+{
+    auto &registered = std::get<0>(users).user;
+    auto patchLevel  = hierarchy->hierarchy->getPatchLevel(0);
+
+    auto binding = resourcesManager.makeLevelBinding(patchLevel, registered);
+
+    registered.nbrSetBufferCalls = 0;
+    for (std::size_t iPatch = 0; iPatch < binding.size(); ++iPatch)
+    {
+        binding.setOnPatch(iPatch);
+        EXPECT_TRUE(registered.isUsable());
+    }
+    binding.reset();
+
+    EXPECT_TRUE(registered.isSettable());
+    EXPECT_EQ(0, registered.nbrSetBufferCalls);
+}
@@ -1,10 +1,13 @@
 
+#include <algorithm>
 #include <type_traits>
+#include <vector>
 
 
 #include "data/grid/gridlayout.h"
 #include "data/grid/gridlayout_impl.h"
 #include "data/ions/particle_initializers/fluid_particle_initializer.h"
+#include "data/ions/particle_initializers/maxwellian_sampler.h"
 #include "data/particles/particle_array.h"
 #include "utilities/function/function.h"
 #include "utilities/point/point.h"
@@ -75,6 +78,334 @@ TEST_F(aFluidParticleInitializer1D, loadsTheCorrectNbrOfParticles)
 
 
 
+TEST_F(aFluidParticleInitializer1D, loadsParticlesInTheDomainCells)
+{
+    initializer->loadParticles(particles, layout);
+
+    auto const firstCell = layout.physicalStartIndex(QtyCentering::primal, Direction::X);
+    auto const endCell   = layout.physicalEndIndex(QtyCentering::primal, Direction::X);
+
+    for (auto const& particle : particles)
+    {
+        EXPECT_LE(static_cast<int>(firstCell), particle.iCell[0]);
+        EXPECT_GT(static_cast<int>(endCell), particle.iCell[0]);
+        EXPECT_LE(0.f, particle.delta[0]);
+        EXPECT_GT(1.f, particle.delta[0]);
+    }
+}
+
+
+
+TEST_F(aFluidParticleInitializer1D, loadsTheSameParticlesWhateverTheNumberOfThreads)
+{
+    using ParticleArrayT = ParticleArray<1>;
+    using GridLayoutT    = GridLayout<GridLayoutImplYee<1, 1>>;
+
+    // enough particles for the loading to be split among the threads
+    uint32 const nbrParticles = 10000;
+
+    auto makeInitializer = [&](std::size_t nbrThreads) {
+        return FluidParticleInitializer<ParticleArrayT, GridLayoutT>{
+            std::make_unique<ScalarFunction<1>>(density),
+            std::make_unique<VectorFunction<1>>(bulkVelocity),
+            std::make_unique<VectorFunction<1>>(thermalvelocity),
+            1.,
+            nbrParticles,
+            Basis::Cartesian,
+            nullptr,
+            12,
+            nbrThreads};
+    };
+
+    ParticleArrayT threadedParticles;
+
+    makeInitializer(1).loadParticles(particles, layout);
+    makeInitializer(4).loadParticles(threadedParticles, layout);
+
+    ASSERT_EQ(particles.size(), threadedParticles.size());
+    for (std::size_t iPart = 0; iPart < particles.size(); ++iPart)
+    {
+        EXPECT_EQ(particles[iPart].iCell, threadedParticles[iPart].iCell);
+        EXPECT_EQ(particles[iPart].delta, threadedParticles[iPart].delta);
+        EXPECT_EQ(particles[iPart].v, threadedParticles[iPart].v);
+        EXPECT_EQ(particles[iPart].weight, threadedParticles[iPart].weight);
+    }
+}
+
+
+
+TEST(AFluidParticleInitializer, loadsTheSameParticlesInACellWhateverThePatch)
+{
+    using ParticleArrayT = ParticleArray<1>;
+    using GridLayoutT    = GridLayout<GridLayoutImplYee<1, 1>>;
+    using InitializerT   = FluidParticleInitializer<ParticleArrayT, GridLayoutT>;
+
+    InitializerT initializer{std::make_unique<ScalarFunction<1>>(density),
+                             std::make_unique<VectorFunction<1>>(bulkVelocity),
+                             std::make_unique<VectorFunction<1>>(thermalvelocity), 1., 10};
+
+    // the second patch covers the cells 10 to 19 of the first one
+    GridLayoutT wholeLayout{{{0.1}}, {{20}}, Point<double, 1>{0.}};
+    GridLayoutT halfLayout{{{0.1}}, {{10}}, Point<double, 1>{1.}};
+
+    ParticleArrayT wholeParticles;
+    ParticleArrayT halfParticles;
+    initializer.loadParticles(wholeParticles, wholeLayout);
+    initializer.loadParticles(halfParticles, halfLayout);
+
+    ASSERT_EQ(wholeParticles.size(), 2 * halfParticles.size());
+
+    auto const cellShift = 10;
+    auto const offset    = halfParticles.size();
+    for (std::size_t iPart = 0; iPart < halfParticles.size(); ++iPart)
+    {
+        auto const& wholeParticle = wholeParticles[offset + iPart];
+        EXPECT_EQ(wholeParticle.iCell[0], halfParticles[iPart].iCell[0] + cellShift);
+        EXPECT_EQ(wholeParticle.delta, halfParticles[iPart].delta);
+        EXPECT_EQ(wholeParticle.v, halfParticles[iPart].v);
+    }
+}
+
+
+
+TEST_F(aFluidParticleInitializer1D, appendsParticlesToThoseAlreadyInTheArray)
+{
+    particles.resize(10);
+    for (auto& particle : particles)
+    {
+        particle.weight = -1.;
+    }
+
+    initializer->loadParticles(particles, layout);
+
+    ASSERT_EQ(10 + nbrParticlesPerCell * layout.nbrCells()[0], particles.size());
+    for (std::size_t iPart = 0; iPart < particles.size(); ++iPart)
+    {
+        EXPECT_EQ(iPart < 10, particles[iPart].weight < 0.);
+    }
+}
+
+
+
+TEST(AFluidParticleInitializer, loadsANumberOfParticlesProportionalToTheDensity)
+{
+    using ParticleArrayT = ParticleArray<1>;
+    using GridLayoutT    = GridLayout<GridLayoutImplYee<1, 1>>;
+    using InitializerT   = FluidParticleInitializer<ParticleArrayT, GridLayoutT>;
+
+    // no particle in the cells of the lower half of the domain, where the density is 0
+    auto linearDensity = [](double x) { return x < 1. ? 0. : x; };
+
+    uint32 const nbrParticlesPerCell = 1000;
+    GridLayoutT layout{{{0.1}}, {{20}}, Point<double, 1>{0.}};
+
+    auto makeInitializer = [&](std::size_t nbrThreads) {
+        return InitializerT{std::make_unique<ScalarFunction<1>>(linearDensity),
+                            std::make_unique<VectorFunction<1>>(bulkVelocity),
+                            std::make_unique<VectorFunction<1>>(thermalvelocity),
+                            1.,
+                            nbrParticlesPerCell,
+                            Basis::Cartesian,
+                            nullptr,
+                            1,
+                            nbrThreads,
+                            ParticleCount::Density};
+    };
+
+    ParticleArrayT particles;
+    makeInitializer(1).loadParticles(particles, layout);
+
+    auto const firstCell = layout.physicalStartIndex(QtyCentering::primal, Direction::X);
+    auto const endCell   = layout.physicalEndIndex(QtyCentering::primal, Direction::X);
+
+    std::size_t expectedNbrParticles = 0;
+    for (auto iCell = firstCell; iCell < endCell; ++iCell)
+    {
+        auto const n = linearDensity(layout.cellCenteredCoordinates(iCell)[0]);
+        expectedNbrParticles += static_cast<std::size_t>(std::lround(n * nbrParticlesPerCell));
+    }
+
+    ASSERT_EQ(expectedNbrParticles, particles.size());
+
+    double totalWeight = 0.;
+    for (auto const& particle : particles)
+    {
+        EXPECT_LE(static_cast<int>(firstCell + 10), particle.iCell[0]);
+        EXPECT_NEAR(0.1 / nbrParticlesPerCell, particle.weight, 1e-12);
+        totalWeight += particle.weight;
+    }
+    EXPECT_NEAR(1.5, totalWeight, 1e-10);
+
+    // chunks of the threaded loading do not match the cells
+    ParticleArrayT threadedParticles;
+    makeInitializer(3).loadParticles(threadedParticles, layout);
+
+    ASSERT_EQ(particles.size(), threadedParticles.size());
+    for (std::size_t iPart = 0; iPart < particles.size(); ++iPart)
+    {
+        EXPECT_EQ(particles[iPart].iCell, threadedParticles[iPart].iCell);
+        EXPECT_EQ(particles[iPart].delta, threadedParticles[iPart].delta);
+        EXPECT_EQ(particles[iPart].v, threadedParticles[iPart].v);
+    }
+}
+
+
+
+TEST(AFluidParticleInitializer, loadsNoParticleWhereTheDensityIsNegative)
+{
+    using ParticleArrayT = ParticleArray<1>;
+    using GridLayoutT    = GridLayout<GridLayoutImplYee<1, 1>>;
+    using InitializerT   = FluidParticleInitializer<ParticleArrayT, GridLayoutT>;
+
+    // negative in the lower half of the domain, 1 in the upper half
+    auto signedDensity = [](double x) { return x < 1. ? -1. : 1.; };
+
+    uint32 const nbrParticlesPerCell = 100;
+    GridLayoutT layout{{{0.1}}, {{20}}, Point<double, 1>{0.}};
+
+    InitializerT initializer{std::make_unique<ScalarFunction<1>>(signedDensity),
+                             std::make_unique<VectorFunction<1>>(bulkVelocity),
+                             std::make_unique<VectorFunction<1>>(thermalvelocity),
+                             1.,
+                             nbrParticlesPerCell,
+                             Basis::Cartesian,
+                             nullptr,
+                             1,
+                             1,
+                             ParticleCount::Density};
+
+    ParticleArrayT particles;
+    initializer.loadParticles(particles, layout);
+
+    auto const firstCell = layout.physicalStartIndex(QtyCentering::primal, Direction::X);
+
+    ASSERT_EQ(10u * nbrParticlesPerCell, particles.size());
+    for (auto const& particle : particles)
+    {
+        EXPECT_LE(static_cast<int>(firstCell + 10), particle.iCell[0]);
+        EXPECT_LT(0., particle.weight);
+    }
+}
+
+
+
+TEST(AFunction, isEvaluatedOnManyPointsWithThePointFunctionByDefault)
+{
+    ScalarFunction<2> function{[](double x, double y) { return x + 10. * y; }};
+
+    std::vector<double> values;
+    function({1., 2., 3.}, {0., 1., 2.}, values);
+
+    EXPECT_THAT(values, ::testing::ElementsAre(1., 12., 23.));
+}
+
+
+
+TEST(AFluidParticleInitializer, evaluatesProfilesWithTheirBatchFunction)
+{
+    using ParticleArrayT = ParticleArray<1>;
+    using GridLayoutT    = GridLayout<GridLayoutImplYee<1, 1>>;
+    using InitializerT   = FluidParticleInitializer<ParticleArrayT, GridLayoutT>;
+
+    std::size_t nbrPointCalls = 0;
+    std::size_t nbrBatchCalls = 0;
+
+    auto pointDensity = [&](double) {
+        ++nbrPointCalls;
+        return 1.;
+    };
+    auto batchDensity = [&](std::vector<double> const& x, std::vector<double>& values) {
+        ++nbrBatchCalls;
+        EXPECT_EQ(x.size(), values.size());
+        std::fill(std::begin(values), std::end(values), 2.);
+    };
+
+    InitializerT initializer{std::make_unique<ScalarFunction<1>>(pointDensity, batchDensity),
+                             std::make_unique<VectorFunction<1>>(bulkVelocity),
+                             std::make_unique<VectorFunction<1>>(thermalvelocity), 1., 10};
+
+    GridLayoutT layout{{{0.1}}, {{20}}, Point<double, 1>{0.}};
+
+    ParticleArrayT particles;
+    initializer.loadParticles(particles, layout);
+
+    EXPECT_EQ(0u, nbrPointCalls);
+    EXPECT_EQ(1u, nbrBatchCalls);
+    ASSERT_EQ(200u, particles.size());
+    for (auto const& particle : particles)
+    {
+        EXPECT_DOUBLE_EQ(2. * 0.1 / 10, particle.weight);
+    }
+}
+
+
+
+TEST(AMaxwellianSampler, drawsTheVelocitiesOfSingleBoxMullerDraws)
+{
+    Philox4x32 const generator{uint64{7}};
+    MaxwellianSampler sampler{generator};
+
+    std::array<double, 3> const V{{1., -2., 0.5}};
+    std::array<double, 3> const Vth{{0.1, 0.2, 0.3}};
+
+    Philox4x32::counter_type counter{{0, 11, 12, 13}};
+    uint32 const firstDraw         = 30;
+    uint32 const drawStride        = 3;
+    std::size_t const nbrParticles = 40;
+
+    MaxwellianSampler::VelocityBlock velocities;
+    sampler(counter, firstDraw, drawStride, nbrParticles, V, Vth, velocities);
+
+    for (uint32 iPart = 0; iPart < nbrParticles; ++iPart)
+    {
+        counter[0]      = firstDraw + iPart * drawStride;
+        auto const bits = generator(counter);
+        counter[0] += 1;
+        auto const moreBits = generator(counter);
+
+        auto const normal01
+            = boxMuller(1. - uniformDouble(bits[0], bits[1]), uniformDouble(bits[2], bits[3]));
+        auto const normal2 = boxMuller(1. - uniformDouble(moreBits[0], moreBits[1]),
+                                       uniformDouble(moreBits[2], moreBits[3]));
+
+        EXPECT_DOUBLE_EQ(V[0] + Vth[0] * normal01[0], velocities.vx[iPart]);
+        EXPECT_DOUBLE_EQ(V[1] + Vth[1] * normal01[1], velocities.vy[iPart]);
+        EXPECT_DOUBLE_EQ(V[2] + Vth[2] * normal2[0], velocities.vz[iPart]);
+    }
+}
+
+
+
+TEST(AMaxwellianSampler, rotatesVelocitiesAsBasisTransform)
+{
+    std::array<std::array<double, 3>, 3> basis;
+    localMagneticBasis({{1., 2., 3.}}, basis);
+
+    MaxwellianSampler::VelocityBlock velocities;
+    std::size_t const nbrParticles = 5;
+    for (std::size_t iPart = 0; iPart < nbrParticles; ++iPart)
+    {
+        velocities.vx[iPart] = 0.1 * iPart;
+        velocities.vy[iPart] = 1. - 0.2 * iPart;
+        velocities.vz[iPart] = 0.5;
+    }
+
+    auto const original = velocities;
+    MaxwellianSampler::rotate(basis, nbrParticles, velocities);
+
+    for (std::size_t iPart = 0; iPart < nbrParticles; ++iPart)
+    {
+        auto const expected = basisTransform(
+            basis, {{original.vx[iPart], original.vy[iPart], original.vz[iPart]}});
+
+        EXPECT_DOUBLE_EQ(expected[0], velocities.vx[iPart]);
+        EXPECT_DOUBLE_EQ(expected[1], velocities.vy[iPart]);
+        EXPECT_DOUBLE_EQ(expected[2], velocities.vz[iPart]);
+    }
+}
+
+
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
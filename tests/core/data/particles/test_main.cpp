@@ -1,13 +1,25 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <random>
 #include <string>
+#include <vector>
 
+#include "data/particles/outgoing_particles.h"
 #include "data/particles/particle.h"
 #include "data/particles/particle_array.h"
+#include "data/particles/particle_array_soa.h"
+#include "data/particles/particle_cell_index.h"
+#include "data/particles/particle_sort.h"
+#include "utilities/box/box.h"
 #include "utilities/point/point.h"
 
+using PHARE::Box;
+using PHARE::CellIndex;
 using PHARE::cellAsPoint;
 using PHARE::Particle;
+using PHARE::ParticleArray;
+using PHARE::ParticleArraySoA;
 using PHARE::Point;
 
 class AParticle : public ::testing::Test
@@ -91,6 +103,354 @@ TEST_F(AParticle, CanBeReducedToAnAbsolutePositionPoint)
 
 
 
+class AParticleArraySoA : public ::testing::Test
+{
+protected:
+    ParticleArraySoA<3> particles;
+
+public:
+    AParticleArraySoA()
+    {
+        for (int i = 0; i < 10; ++i)
+        {
+            Particle<3> part{
+                0.01 * i, 1, {{i, 2 * i, 3 * i}}, {{0.1f, 0.2f, 0.3f}}, {{1., 2., 3.}}};
+            part.Ex = i;
+            particles.push_back(part);
+        }
+    }
+};
+
+
+
+TEST_F(AParticleArraySoA, StoresPushedParticles)
+{
+    EXPECT_EQ(10u, particles.size());
+
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_DOUBLE_EQ(0.01 * i, particles[i].weight);
+        EXPECT_EQ(2 * i, particles[i].iCell[1]);
+        EXPECT_FLOAT_EQ(0.3f, particles[i].delta[2]);
+        EXPECT_DOUBLE_EQ(2., particles[i].v[1]);
+        EXPECT_DOUBLE_EQ(i, particles[i].Ex);
+    }
+}
+
+
+
+TEST_F(AParticleArraySoA, IteratorsGiveAccessToTheUnderlyingArrays)
+{
+    for (auto it = std::begin(particles); it != std::end(particles); ++it)
+    {
+        it->v[0] = 12.;
+    }
+
+    EXPECT_TRUE(std::all_of(std::begin(particles.v()), std::end(particles.v()),
+                            [](auto const& v) { return v[0] == 12.; }));
+}
+
+
+
+TEST_F(AParticleArraySoA, ProxiesConvertToParticles)
+{
+    Particle<3> part = particles[4];
+
+    EXPECT_DOUBLE_EQ(0.04, part.weight);
+    EXPECT_EQ(12, part.iCell[2]);
+
+    part.iCell[2] = 0;
+    EXPECT_EQ(12, particles[4].iCell[2]);
+}
+
+
+
+TEST_F(AParticleArraySoA, CanBePartitioned)
+{
+    auto isEven = [](auto const& part) { return part.iCell[0] % 2 == 0; };
+
+    auto pivot = std::partition(std::begin(particles), std::end(particles), isEven);
+
+    EXPECT_EQ(5, std::distance(std::begin(particles), pivot));
+    EXPECT_TRUE(std::all_of(std::begin(particles), pivot, isEven));
+    EXPECT_TRUE(std::none_of(pivot, std::end(particles), isEven));
+
+    // attributes are swapped along with the cells
+    for (auto const& part : particles)
+    {
+        EXPECT_EQ(2 * part.iCell[0], part.iCell[1]);
+        EXPECT_DOUBLE_EQ(part.iCell[0], part.Ex);
+    }
+}
+
+
+
+TEST_F(AParticleArraySoA, CanEraseItsTail)
+{
+    auto newEnd = std::begin(particles) + 7;
+    particles.erase(newEnd, std::end(particles));
+
+    EXPECT_EQ(7u, particles.size());
+    EXPECT_EQ(6, particles.back().iCell[0]);
+}
+
+
+
+TEST_F(AParticleArraySoA, CanBeReducedToAnIntegerPoint)
+{
+    auto p = cellAsPoint(particles[3]);
+    EXPECT_EQ(3, p[0]);
+    EXPECT_EQ(6, p[1]);
+    EXPECT_EQ(9, p[2]);
+}
+
+
+
+class ACellIndex : public ::testing::Test
+{
+protected:
+    // cells of the index go from (0,0) to (9,7), some particles are outside
+    Box<int, 2> indexBox{Point<int, 2>{0, 0}, Point<int, 2>{9, 7}};
+    CellIndex<2> index{indexBox};
+    ParticleArray<2> particles;
+
+public:
+    ACellIndex()
+    {
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<int> cellX(-1, 10);
+        std::uniform_int_distribution<int> cellY(-1, 8);
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            Particle<2> part;
+            part.iCell  = {{cellX(gen), cellY(gen)}};
+            part.weight = i;
+            particles.push_back(part);
+        }
+    }
+
+
+    static bool isIn(Particle<2> const& part, Box<int, 2> const& box)
+    {
+        return part.iCell[0] >= box.lower[0] && part.iCell[0] <= box.upper[0]
+               && part.iCell[1] >= box.lower[1] && part.iCell[1] <= box.upper[1];
+    }
+};
+
+
+
+TEST_F(ACellIndex, sortsParticlesByCellWithoutLosingAny)
+{
+    auto const original = particles;
+    index.sort(particles);
+
+    EXPECT_EQ(original.size(), index.size());
+    EXPECT_TRUE(std::is_permutation(
+        std::begin(particles), std::end(particles), std::begin(original),
+        [](auto const& a, auto const& b) { return a.weight == b.weight && a.iCell == b.iCell; }));
+
+    auto rowMajor = [](Particle<2> const& a, Particle<2> const& b) {
+        return std::make_pair(a.iCell[1], a.iCell[0]) < std::make_pair(b.iCell[1], b.iCell[0]);
+    };
+    auto const outside = index.outsideRange();
+    EXPECT_TRUE(std::is_sorted(std::begin(particles), std::begin(particles) + outside.first,
+                               rowMajor));
+}
+
+
+
+TEST_F(ACellIndex, putsParticlesOutsideItsBoxAtTheEnd)
+{
+    index.sort(particles);
+    auto const outside = index.outsideRange();
+
+    EXPECT_EQ(particles.size(), outside.second);
+    for (std::size_t iPart = 0; iPart < particles.size(); ++iPart)
+    {
+        EXPECT_EQ(iPart < outside.first, isIn(particles[iPart], indexBox));
+    }
+}
+
+
+
+TEST_F(ACellIndex, selectsTheParticlesOfABox)
+{
+    index.sort(particles);
+
+    Box<int, 2> box{Point<int, 2>{3, -2}, Point<int, 2>{12, 4}};
+
+    std::size_t nbrSelected = 0;
+    index.forEachRangeIn(box, [&](std::size_t first, std::size_t last) {
+        for (auto iPart = first; iPart < last; ++iPart)
+        {
+            EXPECT_TRUE(isIn(particles[iPart], box));
+            EXPECT_TRUE(isIn(particles[iPart], indexBox));
+        }
+        nbrSelected += last - first;
+    });
+
+    auto const nbrExpected = std::count_if(std::begin(particles), std::end(particles),
+                                           [&](auto const& part) {
+                                               return isIn(part, box) && isIn(part, indexBox);
+                                           });
+
+    EXPECT_EQ(static_cast<std::size_t>(nbrExpected), nbrSelected);
+    EXPECT_EQ(nbrSelected, index.count(box));
+}
+
+
+
+TEST_F(ACellIndex, sortsParticleArraySoA)
+{
+    ParticleArraySoA<2> particlesSoA;
+    for (auto const& part : particles)
+    {
+        particlesSoA.push_back(part);
+    }
+
+    index.sort(particles);
+    CellIndex<2> indexSoA{indexBox};
+    indexSoA.sort(particlesSoA);
+
+    ASSERT_EQ(particles.size(), particlesSoA.size());
+    for (std::size_t iPart = 0; iPart < particles.size(); ++iPart)
+    {
+        EXPECT_EQ(particles[iPart].iCell, particlesSoA[iPart].iCell);
+        EXPECT_DOUBLE_EQ(particles[iPart].weight, particlesSoA[iPart].weight);
+    }
+}
+
+
+
+TEST(AMortonKey, interleavesTheBitsOfTheCellIndexes)
+{
+    std::array<int, 2> origin2D{{-2, -2}};
+    EXPECT_EQ(0u, PHARE::mortonKey<2>(std::array<int, 2>{{-2, -2}}, origin2D));
+    EXPECT_EQ(1u, PHARE::mortonKey<2>(std::array<int, 2>{{-1, -2}}, origin2D));
+    EXPECT_EQ(2u, PHARE::mortonKey<2>(std::array<int, 2>{{-2, -1}}, origin2D));
+    EXPECT_EQ(3u, PHARE::mortonKey<2>(std::array<int, 2>{{-1, -1}}, origin2D));
+    EXPECT_EQ(12u, PHARE::mortonKey<2>(std::array<int, 2>{{0, 0}}, origin2D));
+
+    std::array<int, 3> origin3D{{0, 0, 0}};
+    EXPECT_EQ(4u, PHARE::mortonKey<3>(std::array<int, 3>{{0, 0, 1}}, origin3D));
+    EXPECT_EQ(7u, PHARE::mortonKey<3>(std::array<int, 3>{{1, 1, 1}}, origin3D));
+    EXPECT_EQ(56u, PHARE::mortonKey<3>(std::array<int, 3>{{2, 2, 2}}, origin3D));
+}
+
+
+
+class AMortonSort : public ::testing::Test
+{
+protected:
+    ParticleArray<3> particles;
+
+public:
+    AMortonSort()
+    {
+        std::mt19937 gen(7);
+        std::uniform_int_distribution<int> cell(-2, 40);
+
+        for (int i = 0; i < 20000; ++i)
+        {
+            Particle<3> part;
+            part.iCell  = {{cell(gen), cell(gen), cell(gen)}};
+            part.weight = i;
+            particles.push_back(part);
+        }
+    }
+};
+
+
+
+TEST_F(AMortonSort, ordersParticlesAlongTheMortonCurve)
+{
+    auto const original = particles;
+    EXPECT_GT(PHARE::mortonDisorder(particles), 0.4);
+
+    PHARE::sortByMortonOrder(particles);
+
+    EXPECT_DOUBLE_EQ(0., PHARE::mortonDisorder(particles));
+
+    // weights are the original positions of the particles
+    ASSERT_EQ(original.size(), particles.size());
+    std::vector<bool> found(original.size(), false);
+    for (auto const& part : particles)
+    {
+        auto const iOriginal = static_cast<std::size_t>(part.weight);
+        EXPECT_FALSE(found[iOriginal]);
+        EXPECT_EQ(original[iOriginal].iCell, part.iCell);
+        found[iOriginal] = true;
+    }
+}
+
+
+
+TEST_F(AMortonSort, givesTheSameOrderWithSeveralThreads)
+{
+    auto threaded = particles;
+
+    PHARE::sortByMortonOrder(particles);
+    PHARE::sortByMortonOrder(threaded, 4);
+
+    for (std::size_t iPart = 0; iPart < particles.size(); ++iPart)
+    {
+        EXPECT_DOUBLE_EQ(particles[iPart].weight, threaded[iPart].weight);
+    }
+}
+
+
+
+TEST_F(AMortonSort, isTriggeredPeriodicallyOrByDisorder)
+{
+    PHARE::MortonSortPolicy everyThirdStep{3};
+    EXPECT_FALSE(everyThirdStep.sortIfNeeded(particles));
+    EXPECT_FALSE(everyThirdStep.sortIfNeeded(particles));
+    EXPECT_TRUE(everyThirdStep.sortIfNeeded(particles));
+
+    std::shuffle(std::begin(particles), std::end(particles), std::mt19937{1});
+
+    PHARE::MortonSortPolicy onDisorder{0, 0.1};
+    EXPECT_TRUE(onDisorder.sortIfNeeded(particles));
+    EXPECT_FALSE(onDisorder.sortIfNeeded(particles));
+}
+
+
+
+TEST(AnOutgoingParticles, sortsParticlesByLeavingDirectionInAMRIndexes)
+{
+    PHARE::OutgoingParticles<2> outgoing{Box<int, 2>{Point<int, 2>{2, 2}, Point<int, 2>{9, 9}},
+                                         {{10, 20}}};
+
+    Particle<2> part;
+    part.weight = 2.;
+    part.v      = {{1., 2., 3.}};
+    part.iCell  = {{1, 5}};
+    outgoing.push_back(part);
+    part.iCell = {{10, 10}};
+    outgoing.push_back(part);
+    part.iCell = {{11, 12}};
+    outgoing.push_back(part);
+
+    EXPECT_EQ(3u, outgoing.size());
+    ASSERT_EQ(1u, outgoing.bucket({{-1, 0}}).size());
+    EXPECT_EQ((std::array<int, 2>{{11, 25}}), outgoing.bucket({{-1, 0}})[0].iCell);
+    EXPECT_DOUBLE_EQ(2., outgoing.bucket({{-1, 0}})[0].weight);
+    EXPECT_EQ(part.v, outgoing.bucket({{-1, 0}})[0].v);
+    EXPECT_EQ(2u, outgoing.bucket({{1, 1}}).size());
+    EXPECT_TRUE(outgoing.bucket({{1, -1}}).empty());
+
+    auto other = outgoing.emptyCopy();
+    EXPECT_EQ(0u, other.size());
+    other.append(outgoing);
+    EXPECT_EQ(3u, other.size());
+
+    outgoing.clear();
+    EXPECT_EQ(0u, outgoing.size());
+}
+
+
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
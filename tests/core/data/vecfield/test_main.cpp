@@ -294,6 +294,21 @@ TEST_F(VecFieldTest, PhysicalQuantities)
 
 
 
+TEST_F(VecFieldTest, GivesThePointersSetBufferSets)
+{
+    B1D_.getFieldBuffer("B1D_x") = &bx1d_;
+    B1D_.getFieldBuffer("B1D_y") = &by1d_;
+    B1D_.getFieldBuffer("B1D_z") = &bz1d_;
+
+    EXPECT_TRUE(B1D_.isUsable());
+    EXPECT_EQ(&by1d_, &B1D_.getComponent(Component::Y));
+    EXPECT_ANY_THROW(B1D_.getFieldBuffer("B1D_w"));
+
+    unsetBuffers();
+}
+
+
+
 
 int main(int argc, char** argv)
 {
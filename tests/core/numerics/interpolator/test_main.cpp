@@ -17,6 +17,7 @@
 #include "data/vecfield/vecfield.h"
 #include "hybrid/hybrid_quantities.h"
 #include <numerics/interpolator/interpolator.h>
+#include <numerics/interpolator/shape_cache.h>
 
 
 using namespace PHARE;
@@ -278,6 +279,107 @@ TYPED_TEST(A1DInterpolator, canComputeAllEMfieldsAtParticle)
 
 
 
+TYPED_TEST(A1DInterpolator, canComputeAllEMfieldsAtOneParticleWithoutStoringThem)
+{
+    this->em.E.setBuffer("EM_E_x", &this->ex1d_);
+    this->em.E.setBuffer("EM_E_y", &this->ey1d_);
+    this->em.E.setBuffer("EM_E_z", &this->ez1d_);
+    this->em.B.setBuffer("EM_B_x", &this->bx1d_);
+    this->em.B.setBuffer("EM_B_y", &this->by1d_);
+    this->em.B.setBuffer("EM_B_z", &this->bz1d_);
+
+    auto const fields = this->interp(this->particles[0], this->em);
+
+    EXPECT_NEAR(this->ex0, fields.Ex, 1e-8);
+    EXPECT_NEAR(this->ey0, fields.Ey, 1e-8);
+    EXPECT_NEAR(this->ez0, fields.Ez, 1e-8);
+    EXPECT_NEAR(this->bx0, fields.Bx, 1e-8);
+    EXPECT_NEAR(this->by0, fields.By, 1e-8);
+    EXPECT_NEAR(this->bz0, fields.Bz, 1e-8);
+
+    EXPECT_DOUBLE_EQ(0., this->particles[0].Ex);
+    EXPECT_DOUBLE_EQ(0., this->particles[0].Bz);
+
+    this->em.E.setBuffer("EM_E_x", nullptr);
+    this->em.E.setBuffer("EM_E_y", nullptr);
+    this->em.E.setBuffer("EM_E_z", nullptr);
+    this->em.B.setBuffer("EM_B_x", nullptr);
+    this->em.B.setBuffer("EM_B_y", nullptr);
+    this->em.B.setBuffer("EM_B_z", nullptr);
+}
+
+
+
+
+// shapes are only cached above first order, see ShapeCachePolicy
+template<typename InterpolatorT>
+class A1DInterpolatorWithAShapeCache : public A1DInterpolator<InterpolatorT>
+{
+};
+
+using CachedInterpolators1D = ::testing::Types<PHARE::Interpolator<GridLayoutImplYee<1, 2>>,
+                                               PHARE::Interpolator<GridLayoutImplYee<1, 3>>>;
+
+TYPED_TEST_CASE(A1DInterpolatorWithAShapeCache, CachedInterpolators1D);
+
+
+
+
+TYPED_TEST(A1DInterpolatorWithAShapeCache, givesTheSameFieldsAsWithoutIt)
+{
+    this->em.E.setBuffer("EM_E_x", &this->ex1d_);
+    this->em.E.setBuffer("EM_E_y", &this->ey1d_);
+    this->em.E.setBuffer("EM_E_z", &this->ez1d_);
+    this->em.B.setBuffer("EM_B_x", &this->bx1d_);
+    this->em.B.setBuffer("EM_B_y", &this->by1d_);
+    this->em.B.setBuffer("EM_B_z", &this->bz1d_);
+
+    for (auto ix = 0u; ix < this->nx; ++ix)
+    {
+        this->ex1d_(ix) = std::cos(0.3 * ix);
+        this->by1d_(ix) = std::sin(0.2 * ix);
+    }
+
+    auto iPart = 0;
+    for (auto& part : this->particles)
+    {
+        part.iCell[0] = 5 + 3 * iPart++;
+        part.delta[0] = 0.17f * iPart;
+    }
+
+    this->interp(std::begin(this->particles), std::end(this->particles), this->em);
+    auto const computed = this->particles;
+
+    constexpr auto dim         = TypeParam::dimension;
+    constexpr auto interpOrder = TypeParam::interp_order;
+
+    ShapeCache<dim, interpOrder> shapes;
+    shapes.update(std::begin(this->particles), std::end(this->particles));
+
+    for (auto& part : this->particles)
+    {
+        part.Ex = 0.;
+        part.By = 0.;
+    }
+    this->interp(std::begin(this->particles), std::end(this->particles), this->em, shapes);
+
+    for (std::size_t i = 0; i < computed.size(); ++i)
+    {
+        EXPECT_EQ(computed[i].Ex, this->particles[i].Ex);
+        EXPECT_EQ(computed[i].By, this->particles[i].By);
+        EXPECT_EQ(computed[i].Bz, this->particles[i].Bz);
+    }
+
+    this->em.E.setBuffer("EM_E_x", nullptr);
+    this->em.E.setBuffer("EM_E_y", nullptr);
+    this->em.E.setBuffer("EM_E_z", nullptr);
+    this->em.B.setBuffer("EM_B_x", nullptr);
+    this->em.B.setBuffer("EM_B_y", nullptr);
+    this->em.B.setBuffer("EM_B_z", nullptr);
+}
+
+
+
 
 template<typename InterpolatorT>
 class A2DInterpolator : public ::testing::Test
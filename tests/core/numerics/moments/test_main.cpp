@@ -0,0 +1,436 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstddef>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "data/field/field.h"
+#include "data/grid/gridlayout.h"
+#include "data/grid/gridlayout_impl.h"
+#include "data/ions/ion_population/ion_population.h"
+#include "data/ndarray/ndarray_vector.h"
+#include "data/particles/particle.h"
+#include "data/particles/particle_array.h"
+#include "data/particles/particle_array_soa.h"
+#include "data/vecfield/vecfield.h"
+#include "hybrid/hybrid_quantities.h"
+#include "numerics/interpolator/shape_cache.h"
+#include "numerics/moments/moments.h"
+
+
+using namespace PHARE;
+
+
+
+template<std::size_t dim>
+struct NdArrayOf
+{
+};
+
+template<>
+struct NdArrayOf<1>
+{
+    using type = NdArrayVector1D<>;
+};
+
+template<>
+struct NdArrayOf<2>
+{
+    using type = NdArrayVector2D<>;
+};
+
+template<>
+struct NdArrayOf<3>
+{
+    using type = NdArrayVector3D<>;
+};
+
+
+
+template<typename GridLayoutImpl>
+class AMomentsDepositor : public ::testing::Test
+{
+public:
+    static constexpr std::size_t dim = GridLayoutImpl::dimension;
+
+    using NdArray   = typename NdArrayOf<dim>::type;
+    using FieldT    = Field<NdArray, HybridQuantity::Scalar>;
+    using VecFieldT = VecField<NdArray, HybridQuantity>;
+
+    static constexpr uint32 nbrCells = dim == 1 ? 100 : (dim == 2 ? 20 : 8);
+
+    GridLayout<GridLayoutImpl> layout;
+
+    FieldT rho;
+    FieldT Fx;
+    FieldT Fy;
+    FieldT Fz;
+    VecFieldT flux;
+
+    ParticleArray<dim> particles;
+
+
+    AMomentsDepositor()
+        : layout{meshSize_(), cells_(), Point<double, dim>{}}
+        , rho{"rho", HybridQuantity::Scalar::rho, layout.allocSize(HybridQuantity::Scalar::rho)}
+        , Fx{"F_x", HybridQuantity::Scalar::Vx, layout.allocSize(HybridQuantity::Scalar::Vx)}
+        , Fy{"F_y", HybridQuantity::Scalar::Vy, layout.allocSize(HybridQuantity::Scalar::Vy)}
+        , Fz{"F_z", HybridQuantity::Scalar::Vz, layout.allocSize(HybridQuantity::Scalar::Vz)}
+        , flux{"F", HybridQuantity::Vector::V}
+    {
+        flux.setBuffer("F_x", &Fx);
+        flux.setBuffer("F_y", &Fy);
+        flux.setBuffer("F_z", &Fz);
+
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<int> cell(0, static_cast<int>(nbrCells) - 1);
+        std::uniform_real_distribution<float> delta(0.f, 1.f);
+        std::uniform_real_distribution<double> velocity(-1., 1.);
+        std::uniform_real_distribution<double> weight(0.5, 1.5);
+
+        particles.resize(20000);
+        for (auto& part : particles)
+        {
+            part.weight = weight(gen);
+            part.charge = 1.;
+            for (auto iDim = 0u; iDim < dim; ++iDim)
+            {
+                part.iCell[iDim] = static_cast<int>(layout.physicalStartIndex(
+                                       QtyCentering::primal, static_cast<Direction>(iDim)))
+                                   + cell(gen);
+                part.delta[iDim] = delta(gen);
+            }
+            part.v = {{velocity(gen), velocity(gen), velocity(gen)}};
+        }
+    }
+
+
+    static double sum(FieldT const& field)
+    {
+        return std::accumulate(field.begin(), field.end(), 0.);
+    }
+
+
+    static std::vector<double> values(FieldT const& field)
+    {
+        return std::vector<double>(field.begin(), field.end());
+    }
+
+
+    void zero()
+    {
+        rho.zero();
+        Fx.zero();
+        Fy.zero();
+        Fz.zero();
+    }
+
+
+private:
+    static std::array<double, dim> meshSize_()
+    {
+        std::array<double, dim> meshSize;
+        meshSize.fill(0.1);
+        return meshSize;
+    }
+
+    static std::array<uint32, dim> cells_()
+    {
+        std::array<uint32, dim> cells;
+        cells.fill(nbrCells);
+        return cells;
+    }
+};
+
+
+
+using GridLayoutImpls
+    = ::testing::Types<GridLayoutImplYee<1, 1>, GridLayoutImplYee<1, 2>, GridLayoutImplYee<1, 3>,
+                       GridLayoutImplYee<2, 1>, GridLayoutImplYee<2, 2>, GridLayoutImplYee<2, 3>,
+                       GridLayoutImplYee<3, 1>, GridLayoutImplYee<3, 2>, GridLayoutImplYee<3, 3>>;
+
+TYPED_TEST_CASE(AMomentsDepositor, GridLayoutImpls);
+
+
+
+
+TYPED_TEST(AMomentsDepositor, depositsTheTotalWeightAndFluxOfParticles)
+{
+    MomentsDepositor<TypeParam> deposit;
+    deposit(std::begin(this->particles), std::end(this->particles), this->rho, this->flux,
+            this->layout);
+
+    double totalWeight = 0.;
+    std::array<double, 3> totalFlux{{0., 0., 0.}};
+    for (auto const& part : this->particles)
+    {
+        totalWeight += part.weight;
+        for (auto iComp = 0u; iComp < 3; ++iComp)
+        {
+            totalFlux[iComp] += part.weight * part.v[iComp];
+        }
+    }
+
+    EXPECT_NEAR(totalWeight, this->sum(this->rho), 1e-8 * totalWeight);
+    EXPECT_NEAR(totalFlux[0], this->sum(this->Fx), 1e-8 * totalWeight);
+    EXPECT_NEAR(totalFlux[1], this->sum(this->Fy), 1e-8 * totalWeight);
+    EXPECT_NEAR(totalFlux[2], this->sum(this->Fz), 1e-8 * totalWeight);
+}
+
+
+
+
+TYPED_TEST(AMomentsDepositor, givesTheSameMomentsWithSeveralThreads)
+{
+    MomentsDepositor<TypeParam> serial;
+    serial(std::begin(this->particles), std::end(this->particles), this->rho, this->flux,
+           this->layout);
+
+    auto const serialRho = this->values(this->rho);
+    auto const serialFx  = this->values(this->Fx);
+
+    MomentsDepositor<TypeParam> threaded{4};
+
+    this->zero();
+    threaded(std::begin(this->particles), std::end(this->particles), this->rho, this->flux,
+             this->layout);
+
+    auto const threadedRho = this->values(this->rho);
+    auto const threadedFx  = this->values(this->Fx);
+
+    for (std::size_t i = 0; i < serialRho.size(); ++i)
+    {
+        EXPECT_NEAR(serialRho[i], threadedRho[i], 1e-10);
+        EXPECT_NEAR(serialFx[i], threadedFx[i], 1e-10);
+    }
+
+    // the reduction order is fixed, so that threaded runs give the exact same moments
+    this->zero();
+    threaded(std::begin(this->particles), std::end(this->particles), this->rho, this->flux,
+             this->layout);
+
+    EXPECT_EQ(threadedRho, this->values(this->rho));
+    EXPECT_EQ(threadedFx, this->values(this->Fx));
+}
+
+
+
+
+// shapes are only cached above first order, see ShapeCachePolicy
+template<typename GridLayoutImpl>
+class AMomentsDepositorWithAShapeCache : public AMomentsDepositor<GridLayoutImpl>
+{
+};
+
+using CachedGridLayoutImpls
+    = ::testing::Types<GridLayoutImplYee<1, 2>, GridLayoutImplYee<1, 3>, GridLayoutImplYee<2, 2>,
+                       GridLayoutImplYee<2, 3>, GridLayoutImplYee<3, 2>, GridLayoutImplYee<3, 3>>;
+
+TYPED_TEST_CASE(AMomentsDepositorWithAShapeCache, CachedGridLayoutImpls);
+
+
+
+
+TYPED_TEST(AMomentsDepositorWithAShapeCache, givesTheSameMomentsAsWithoutIt)
+{
+    MomentsDepositor<TypeParam> deposit;
+    deposit(std::begin(this->particles), std::end(this->particles), this->rho, this->flux,
+            this->layout);
+
+    auto const rho = this->values(this->rho);
+    auto const Fx  = this->values(this->Fx);
+    auto const Fz  = this->values(this->Fz);
+
+    ShapeCache<TypeParam::dimension, TypeParam::interp_order> shapes;
+    shapes.update(std::begin(this->particles), std::end(this->particles));
+    EXPECT_EQ(this->particles.size(), shapes.size());
+
+    this->zero();
+    deposit(std::begin(this->particles), std::end(this->particles), this->rho, this->flux,
+            this->layout, shapes);
+
+    EXPECT_EQ(rho, this->values(this->rho));
+    EXPECT_EQ(Fx, this->values(this->Fx));
+    EXPECT_EQ(Fz, this->values(this->Fz));
+
+    MomentsDepositor<TypeParam> threaded{4};
+
+    this->zero();
+    threaded(std::begin(this->particles), std::end(this->particles), this->rho, this->flux,
+             this->layout);
+
+    auto const threadedRho = this->values(this->rho);
+
+    this->zero();
+    threaded(std::begin(this->particles), std::end(this->particles), this->rho, this->flux,
+             this->layout, shapes);
+
+    EXPECT_EQ(threadedRho, this->values(this->rho));
+}
+
+
+
+
+TYPED_TEST(AMomentsDepositorWithAShapeCache, throwsIfItDoesNotMatchTheParticles)
+{
+    ShapeCache<TypeParam::dimension, TypeParam::interp_order> shapes;
+    shapes.update(std::begin(this->particles), std::begin(this->particles) + 10);
+
+    MomentsDepositor<TypeParam> deposit;
+    EXPECT_THROW(deposit(std::begin(this->particles), std::end(this->particles), this->rho,
+                         this->flux, this->layout, shapes),
+                 std::runtime_error);
+}
+
+
+
+
+TEST(AShapeCachePolicy, cachesShapesAboveFirstOrder)
+{
+    EXPECT_FALSE(ShapeCachePolicy<1>::enabled);
+    EXPECT_TRUE(ShapeCachePolicy<2>::enabled);
+    EXPECT_TRUE(ShapeCachePolicy<3>::enabled);
+}
+
+
+
+
+TEST(AMomentsDepositor1D, depositsLinearWeightsOnTheTwoClosestPrimalNodes)
+{
+    using GridLayoutImpl = GridLayoutImplYee<1, 1>;
+    using FieldT         = Field<NdArrayVector1D<>, HybridQuantity::Scalar>;
+
+    GridLayout<GridLayoutImpl> layout{{{0.1}}, {{20}}, Point<double, 1>{0.}};
+
+    FieldT rho{"rho", HybridQuantity::Scalar::rho, layout.allocSize(HybridQuantity::Scalar::rho)};
+    FieldT Fx{"F_x", HybridQuantity::Scalar::Vx, layout.allocSize(HybridQuantity::Scalar::Vx)};
+    FieldT Fy{"F_y", HybridQuantity::Scalar::Vy, layout.allocSize(HybridQuantity::Scalar::Vy)};
+    FieldT Fz{"F_z", HybridQuantity::Scalar::Vz, layout.allocSize(HybridQuantity::Scalar::Vz)};
+    VecField<NdArrayVector1D<>, HybridQuantity> flux{"F", HybridQuantity::Vector::V};
+    flux.setBuffer("F_x", &Fx);
+    flux.setBuffer("F_y", &Fy);
+    flux.setBuffer("F_z", &Fz);
+
+    ParticleArray<1> particles(1);
+    particles[0].weight = 2.;
+    particles[0].iCell  = {{5}};
+    particles[0].delta  = {{0.25f}};
+    particles[0].v      = {{1., -2., 3.}};
+
+    MomentsDepositor<GridLayoutImpl> deposit;
+    deposit(std::begin(particles), std::end(particles), rho, flux, layout);
+
+    EXPECT_DOUBLE_EQ(1.5, rho(5));
+    EXPECT_DOUBLE_EQ(0.5, rho(6));
+    EXPECT_DOUBLE_EQ(1.5, Fx(5));
+    EXPECT_DOUBLE_EQ(-3., Fy(5));
+    EXPECT_DOUBLE_EQ(1.5, Fz(6));
+    EXPECT_DOUBLE_EQ(2., std::accumulate(rho.begin(), rho.end(), 0.));
+}
+
+
+
+
+TEST(AMomentsDepositor1D, computesPopulationMomentsFromParticleArraySoA)
+{
+    using GridLayoutImpl = GridLayoutImplYee<1, 1>;
+    using VecFieldT      = VecField<NdArrayVector1D<>, HybridQuantity>;
+    using FieldT         = typename VecFieldT::field_type;
+
+    GridLayout<GridLayoutImpl> layout{{{0.1}}, {{20}}, Point<double, 1>{0.}};
+
+    FieldT rho{"rho", HybridQuantity::Scalar::rho, layout.allocSize(HybridQuantity::Scalar::rho)};
+    FieldT Fx{"F_x", HybridQuantity::Scalar::Vx, layout.allocSize(HybridQuantity::Scalar::Vx)};
+    FieldT Fy{"F_y", HybridQuantity::Scalar::Vy, layout.allocSize(HybridQuantity::Scalar::Vy)};
+    FieldT Fz{"F_z", HybridQuantity::Scalar::Vz, layout.allocSize(HybridQuantity::Scalar::Vz)};
+
+    ParticleArraySoA<1> domain(1);
+    ParticleArraySoA<1> ghost(1);
+    ParticleArraySoA<1> coarseToFine(1);
+    domain[0].weight = 1.;
+    domain[0].iCell  = {{5}};
+    domain[0].v      = {{2., 0., 0.}};
+    ghost[0].weight  = 1.;
+    ghost[0].iCell   = {{0}};
+    ghost[0].v       = {{0., 0., 0.}};
+
+    ParticlesPack<ParticleArraySoA<1>> pack{&domain, &ghost, &coarseToFine};
+
+    IonPopulation<ParticleArraySoA<1>, VecFieldT> protons{"protons", 1.};
+    protons.setBuffer("protons", &pack);
+    protons.setBuffer("protons_rho", &rho);
+    auto& popFlux = std::get<0>(protons.getCompileTimeResourcesUserList());
+    popFlux.setBuffer("protons_flux_x", &Fx);
+    popFlux.setBuffer("protons_flux_y", &Fy);
+    popFlux.setBuffer("protons_flux_z", &Fz);
+
+    MomentsDepositor<GridLayoutImpl> deposit;
+    deposit(protons, layout);
+
+    EXPECT_DOUBLE_EQ(1., rho(5));
+    EXPECT_DOUBLE_EQ(1., rho(0));
+    EXPECT_DOUBLE_EQ(2., std::accumulate(rho.begin(), rho.end(), 0.));
+    EXPECT_DOUBLE_EQ(2., std::accumulate(Fx.begin(), Fx.end(), 0.));
+}
+
+
+
+
+TEST(AMomentsDepositor1D, computesPopulationMomentsFromDomainAndGhostParticles)
+{
+    using GridLayoutImpl = GridLayoutImplYee<1, 1>;
+    using VecFieldT      = VecField<NdArrayVector1D<>, HybridQuantity>;
+    using FieldT         = typename VecFieldT::field_type;
+
+    GridLayout<GridLayoutImpl> layout{{{0.1}}, {{20}}, Point<double, 1>{0.}};
+
+    FieldT rho{"rho", HybridQuantity::Scalar::rho, layout.allocSize(HybridQuantity::Scalar::rho)};
+    FieldT Fx{"F_x", HybridQuantity::Scalar::Vx, layout.allocSize(HybridQuantity::Scalar::Vx)};
+    FieldT Fy{"F_y", HybridQuantity::Scalar::Vy, layout.allocSize(HybridQuantity::Scalar::Vy)};
+    FieldT Fz{"F_z", HybridQuantity::Scalar::Vz, layout.allocSize(HybridQuantity::Scalar::Vz)};
+
+    ParticleArray<1> domain(1);
+    ParticleArray<1> ghost(1);
+    ParticleArray<1> coarseToFine(1);
+    domain[0].weight       = 1.;
+    domain[0].iCell        = {{5}};
+    ghost[0].weight        = 1.;
+    ghost[0].iCell         = {{0}};
+    coarseToFine[0].weight = 1.;
+    coarseToFine[0].iCell  = {{10}};
+
+    ParticlesPack<ParticleArray<1>> pack{&domain, &ghost, &coarseToFine};
+
+    IonPopulation<ParticleArray<1>, VecFieldT> protons{"protons", 1.};
+    protons.setBuffer("protons", &pack);
+    protons.setBuffer("protons_rho", &rho);
+    auto& popFlux = std::get<0>(protons.getCompileTimeResourcesUserList());
+    popFlux.setBuffer("protons_flux_x", &Fx);
+    popFlux.setBuffer("protons_flux_y", &Fy);
+    popFlux.setBuffer("protons_flux_z", &Fz);
+
+    rho(10) = 5.;
+
+    MomentsDepositor<GridLayoutImpl> deposit;
+    deposit(protons, layout);
+
+    EXPECT_DOUBLE_EQ(1., rho(5));
+    EXPECT_DOUBLE_EQ(1., rho(0));
+    EXPECT_DOUBLE_EQ(0., rho(10));
+    EXPECT_DOUBLE_EQ(2., std::accumulate(rho.begin(), rho.end(), 0.));
+}
+
+
+
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
@@ -1,17 +1,23 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <fstream>
 #include <iterator>
 #include <memory>
 #include <random>
 #include <string>
+#include <tuple>
 #include <vector>
 
+#include "data/particles/outgoing_particles.h"
 #include "data/particles/particle_array.h"
+#include "data/particles/particle_array_soa.h"
 #include "numerics/boundary_condition/boundary_condition.h"
 #include "numerics/pusher/boris.h"
+#include "numerics/pusher/boris_velocity.h"
 #include "numerics/pusher/pusher_factory.h"
 #include "utilities/particle_selector/particle_selector.h"
 #include "utilities/range/range.h"
@@ -74,6 +80,12 @@ Trajectory readExpectedTrajectory()
 class Interpolator
 {
 public:
+    struct Fields
+    {
+        double Ex = 0.01, Ey = -0.05, Ez = 0.05;
+        double Bx = 1., By = 1., Bz = 1.;
+    };
+
     template<typename PartIterator, typename Electromag>
     void operator()(PartIterator begin, PartIterator end, Electromag const& em)
     {
@@ -87,6 +99,13 @@ public:
             currPart->Bz = 1.;
         }
     }
+
+    // used by the fused pusher, which does not store fields on particles
+    template<typename Particle, typename Electromag>
+    Fields operator()(Particle const&, Electromag const&)
+    {
+        return Fields{};
+    }
 };
 
 
@@ -286,6 +305,39 @@ TEST_F(APusher3D, trajectoryIsOk)
 
 
 
+TEST_F(APusher3D, fusedPusherTrajectoryIsOk)
+{
+    auto fusedPusher = PusherFactory::makePusher<3, ParticleArray<3>::iterator, Electromag,
+                                                 Interpolator, DummySelector,
+                                                 BoundaryCondition<3, 1>>("boris_fused");
+    fusedPusher->setMeshAndTimeStep({{dx, dy, dz}}, dt);
+
+    auto rangeIn  = makeRange(std::begin(particlesIn), std::end(particlesIn));
+    auto rangeOut = makeRange(std::begin(particlesOut), std::end(particlesOut));
+    std::copy(rangeIn.begin(), rangeIn.end(), rangeOut.begin());
+
+    for (decltype(nt) i = 0; i < nt; ++i)
+    {
+        xActual[i] = (particlesOut[0].iCell[0] + particlesOut[0].delta[0]) * static_cast<float>(dx);
+        yActual[i] = (particlesOut[0].iCell[1] + particlesOut[0].delta[1]) * static_cast<float>(dy);
+        zActual[i] = (particlesOut[0].iCell[2] + particlesOut[0].delta[2]) * static_cast<float>(dz);
+
+        fusedPusher->move(rangeIn, rangeOut, em, mass, interpolator, selector);
+
+        std::copy(rangeOut.begin(), rangeOut.end(), rangeIn.begin());
+    }
+
+    // the fused pusher never stores fields on particles
+    EXPECT_DOUBLE_EQ(0., particlesOut[0].Bx);
+
+    EXPECT_THAT(xActual, ::testing::Pointwise(::testing::DoubleNear(1e-5), expectedTrajectory.x));
+    EXPECT_THAT(yActual, ::testing::Pointwise(::testing::DoubleNear(1e-5), expectedTrajectory.y));
+    EXPECT_THAT(zActual, ::testing::Pointwise(::testing::DoubleNear(1e-5), expectedTrajectory.z));
+}
+
+
+
+
 TEST_F(APusher2D, trajectoryIsOk)
 {
     auto rangeIn  = makeRange(std::begin(particlesIn), std::end(particlesIn));
@@ -495,6 +547,314 @@ TEST_F(APusherWithLeavingParticles, pusherWithOrWithingBCReturnsReturnEqualStayi
 
 
 
+TEST_F(APusherWithLeavingParticles, pushesParticleArraySoAAsParticleArray)
+{
+    ParticleArraySoA<1> particlesSoA;
+    for (auto const& part : particlesIn)
+    {
+        particlesSoA.push_back(part);
+    }
+
+    BorisPusher<1, ParticleArraySoA<1>::iterator, Electromag, Interpolator,
+                ParticleSelector<Box<int, 1>>, BoundaryCondition<1, 1>>
+        pusherSoA;
+    pusherSoA.setMeshAndTimeStep({{dx}}, dt);
+
+    auto rangeIn    = makeRange(std::begin(particlesIn), std::end(particlesIn));
+    auto rangeInSoA = makeRange(std::begin(particlesSoA), std::end(particlesSoA));
+
+    auto newEnd    = std::end(particlesIn);
+    auto newEndSoA = std::end(particlesSoA);
+
+    for (decltype(nt) i = 0; i < nt; ++i)
+    {
+        newEnd    = pusher->move(rangeIn, rangeIn, em, mass, interpolator, selector);
+        newEndSoA = pusherSoA.move(rangeInSoA, rangeInSoA, em, mass, interpolator, selector);
+        if (newEnd != std::end(particlesIn))
+        {
+            break;
+        }
+    }
+
+    ASSERT_EQ(std::distance(std::begin(particlesIn), newEnd),
+              std::distance(std::begin(particlesSoA), newEndSoA));
+
+    for (std::size_t i = 0; i < particlesIn.size(); ++i)
+    {
+        EXPECT_EQ(particlesIn[i].iCell[0], particlesSoA[i].iCell[0]);
+        EXPECT_FLOAT_EQ(particlesIn[i].delta[0], particlesSoA[i].delta[0]);
+        EXPECT_DOUBLE_EQ(particlesIn[i].v[0], particlesSoA[i].v[0]);
+        EXPECT_DOUBLE_EQ(particlesIn[i].v[1], particlesSoA[i].v[1]);
+    }
+}
+
+
+
+TEST(AThreadedPusher, returnsTheSamePartitionAsTheSerialPusher)
+{
+    using BorisPusher1D = BorisPusher<1, ParticleArray<1>::iterator, Electromag, Interpolator,
+                                      ParticleSelector<Box<int, 1>>, BoundaryCondition<1, 1>>;
+
+    std::size_t const nbrParticles = 100000;
+    double const dx                = 0.05;
+    double const dt                = 0.01;
+
+    std::mt19937 gen(12);
+    std::uniform_int_distribution<> cell(0, 9);
+    std::uniform_real_distribution<float> delta(0, 1);
+    std::uniform_real_distribution<double> velocity(-5, 5);
+
+    ParticleArray<1> particlesSerial(nbrParticles);
+    for (auto& part : particlesSerial)
+    {
+        part.charge = 1;
+        part.v      = {{velocity(gen), velocity(gen), velocity(gen)}};
+        part.delta  = {{delta(gen)}};
+        part.iCell  = {{cell(gen)}};
+    }
+    ParticleArray<1> particlesThreaded{particlesSerial};
+
+    BorisPusher1D serialPusher;
+    BorisPusher1D threadedPusher{4};
+    serialPusher.setMeshAndTimeStep({{dx}}, dt);
+    threadedPusher.setMeshAndTimeStep({{dx}}, dt);
+
+    Box<int, 1> domain{Point<int, 1>{0}, Point<int, 1>{9}};
+    ParticleSelector<Box<int, 1>> selector{domain};
+    Electromag em;
+    Interpolator interpolator;
+
+    auto rangeSerial   = makeRange(std::begin(particlesSerial), std::end(particlesSerial));
+    auto rangeThreaded = makeRange(std::begin(particlesThreaded), std::end(particlesThreaded));
+
+    auto newEndSerial
+        = serialPusher.move(rangeSerial, rangeSerial, em, 1., interpolator, selector);
+    auto newEndThreaded
+        = threadedPusher.move(rangeThreaded, rangeThreaded, em, 1., interpolator, selector);
+
+    auto nbrStaying = std::distance(std::begin(particlesSerial), newEndSerial);
+    ASSERT_GT(nbrStaying, 0);
+    ASSERT_LT(nbrStaying, static_cast<long>(nbrParticles));
+    EXPECT_EQ(nbrStaying, std::distance(std::begin(particlesThreaded), newEndThreaded));
+
+    EXPECT_TRUE(std::all_of(std::begin(particlesThreaded), newEndThreaded, selector));
+    EXPECT_TRUE(std::none_of(newEndThreaded, std::end(particlesThreaded), selector));
+
+    // both pushers see the same particles, possibly in a different order
+    auto byPositionAndVelocity = [](Particle<1> const& a, Particle<1> const& b) {
+        return std::tie(a.iCell[0], a.delta[0], a.v[0]) < std::tie(b.iCell[0], b.delta[0], b.v[0]);
+    };
+    std::sort(std::begin(particlesSerial), newEndSerial, byPositionAndVelocity);
+    std::sort(std::begin(particlesThreaded), newEndThreaded, byPositionAndVelocity);
+
+    for (auto i = 0; i < nbrStaying; ++i)
+    {
+        EXPECT_EQ(particlesSerial[i].iCell[0], particlesThreaded[i].iCell[0]);
+        EXPECT_FLOAT_EQ(particlesSerial[i].delta[0], particlesThreaded[i].delta[0]);
+        EXPECT_DOUBLE_EQ(particlesSerial[i].v[0], particlesThreaded[i].v[0]);
+    }
+}
+
+
+TEST(AnOutgoingPusher, putsLeavingParticlesInTheBucketOfTheirDirection)
+{
+    using BorisPusher1D = BorisPusher<1, ParticleArray<1>::iterator, Electromag, Interpolator,
+                                      ParticleSelector<Box<int, 1>>, BoundaryCondition<1, 1>>;
+
+    std::size_t const nbrParticles = 100000;
+    int const localToAMR           = 100;
+
+    std::mt19937 gen(13);
+    std::uniform_int_distribution<> cell(0, 8);
+    std::uniform_real_distribution<float> delta(0, 1);
+    std::uniform_real_distribution<double> velocity(-5, 5);
+
+    ParticleArray<1> particles(nbrParticles);
+    for (auto& part : particles)
+    {
+        part.charge = 1;
+        part.v      = {{velocity(gen), velocity(gen), velocity(gen)}};
+        part.delta  = {{delta(gen)}};
+        part.iCell  = {{cell(gen)}};
+    }
+
+    // staying cells are 0 to 8, the upper bound of the selector box being excluded
+    ParticleSelector<Box<int, 1>> selector{Box<int, 1>{Point<int, 1>{0}, Point<int, 1>{9}}};
+    Box<int, 1> domainBox{Point<int, 1>{0}, Point<int, 1>{8}};
+    Electromag em;
+    Interpolator interpolator;
+
+    for (std::size_t nbrThreads : {1u, 4u})
+    {
+        auto swapped  = particles;
+        auto outgoing = particles;
+
+        BorisPusher1D pusher{nbrThreads};
+        pusher.setMeshAndTimeStep({{0.05}}, 0.01);
+
+        auto rangeSwapped  = makeRange(std::begin(swapped), std::end(swapped));
+        auto rangeOutgoing = makeRange(std::begin(outgoing), std::end(outgoing));
+        OutgoingParticles<1> leaving{domainBox, {{localToAMR}}};
+
+        auto swappedEnd = pusher.move(rangeSwapped, rangeSwapped, em, 1., interpolator, selector);
+        auto outgoingEnd
+            = pusher.move(rangeOutgoing, rangeOutgoing, em, 1., interpolator, selector, leaving);
+
+        auto nbrStaying = std::distance(std::begin(swapped), swappedEnd);
+        ASSERT_LT(nbrStaying, static_cast<long>(nbrParticles));
+        EXPECT_EQ(nbrStaying, std::distance(std::begin(outgoing), outgoingEnd));
+        EXPECT_EQ(nbrParticles - nbrStaying, leaving.size());
+
+        EXPECT_TRUE(std::all_of(std::begin(outgoing), outgoingEnd, selector));
+        EXPECT_TRUE(leaving.bucket({{0}}).empty());
+        for (auto const& part : leaving.bucket({{-1}}))
+        {
+            EXPECT_LT(part.iCell[0], localToAMR);
+        }
+        for (auto const& part : leaving.bucket({{1}}))
+        {
+            EXPECT_GT(part.iCell[0], 8 + localToAMR);
+        }
+
+        // the leaving particles are the same as those the other move() puts at the end
+        auto byPosition = [](auto const& a, auto const& b) {
+            return std::tie(a.iCell[0], a.delta[0], a.v[0])
+                   < std::tie(b.iCell[0], b.delta[0], b.v[0]);
+        };
+        std::vector<Particle<1>> expectedLeaving(swappedEnd, std::end(swapped));
+        for (auto& part : expectedLeaving)
+        {
+            part.iCell[0] += localToAMR;
+        }
+        auto actualLeaving = leaving.bucket({{-1}});
+        actualLeaving.insert(std::end(actualLeaving), std::begin(leaving.bucket({{1}})),
+                             std::end(leaving.bucket({{1}})));
+
+        std::sort(std::begin(expectedLeaving), std::end(expectedLeaving), byPosition);
+        std::sort(std::begin(actualLeaving), std::end(actualLeaving), byPosition);
+        ASSERT_EQ(expectedLeaving.size(), actualLeaving.size());
+        for (std::size_t i = 0; i < actualLeaving.size(); ++i)
+        {
+            EXPECT_EQ(expectedLeaving[i].iCell[0], actualLeaving[i].iCell[0]);
+            EXPECT_DOUBLE_EQ(expectedLeaving[i].v[0], actualLeaving[i].v[0]);
+        }
+    }
+}
+
+
+
+TEST(AnOutgoingPusher, keepsOutOfTheBucketsParticlesLeavingThroughAPhysicalBoundary)
+{
+    using BorisPusher1D = BorisPusher<1, ParticleArray<1>::iterator, Electromag, Interpolator,
+                                      ParticleSelector<Box<int, 1>>, BoundaryCondition<1, 1>>;
+
+    std::size_t const nbrParticles = 100000;
+    int const localToAMR           = 100;
+
+    std::mt19937 gen(17);
+    std::uniform_int_distribution<> cell(0, 8);
+    std::uniform_real_distribution<float> delta(0, 1);
+    std::uniform_real_distribution<double> velocity(-5, 5);
+
+    ParticleArray<1> particles(nbrParticles);
+    for (auto& part : particles)
+    {
+        part.charge = 1;
+        part.v      = {{velocity(gen), velocity(gen), velocity(gen)}};
+        part.delta  = {{delta(gen)}};
+        part.iCell  = {{cell(gen)}};
+    }
+
+    ParticleSelector<Box<int, 1>> selector{Box<int, 1>{Point<int, 1>{0}, Point<int, 1>{9}}};
+    Box<int, 1> domainBox{Point<int, 1>{0}, Point<int, 1>{8}};
+    Electromag em;
+    Interpolator interpolator;
+
+    // the upper side of the patch is a physical boundary
+    BoundaryCondition<1, 1> bc;
+    bc.setBoundaryBoxes({Box<int, 1>{Point<int, 1>{9}, Point<int, 1>{1000}}});
+
+    for (std::size_t nbrThreads : {1u, 4u})
+    {
+        auto swapped  = particles;
+        auto outgoing = particles;
+
+        BorisPusher1D pusher{nbrThreads};
+        pusher.setMeshAndTimeStep({{0.05}}, 0.01);
+
+        auto rangeSwapped  = makeRange(std::begin(swapped), std::end(swapped));
+        auto rangeOutgoing = makeRange(std::begin(outgoing), std::end(outgoing));
+        OutgoingParticles<1> leaving{domainBox, {{localToAMR}}};
+
+        auto swappedEnd
+            = pusher.move(rangeSwapped, rangeSwapped, em, 1., interpolator, selector, bc);
+        auto newEnd = pusher.move(rangeOutgoing, rangeOutgoing, em, 1., interpolator, selector,
+                                  bc, leaving);
+
+        auto nbrKept = std::distance(std::begin(outgoing), newEnd);
+        EXPECT_EQ(std::distance(std::begin(swapped), swappedEnd), nbrKept);
+        EXPECT_EQ(nbrParticles - nbrKept, leaving.size());
+        EXPECT_FALSE(leaving.bucket({{-1}}).empty());
+        EXPECT_TRUE(leaving.bucket({{1}}).empty());
+
+        // the boundary condition keeps the particles leaving through the upper side
+        EXPECT_TRUE(std::any_of(std::begin(outgoing), newEnd,
+                                [](Particle<1> const& part) { return part.iCell[0] > 8; }));
+        EXPECT_TRUE(std::none_of(std::begin(outgoing), newEnd,
+                                 [](Particle<1> const& part) { return part.iCell[0] < 0; }));
+        for (auto const& part : leaving.bucket({{-1}}))
+        {
+            EXPECT_LT(part.iCell[0], localToAMR);
+        }
+    }
+}
+
+
+
+struct RandomFields
+{
+    double Ex, Ey, Ez;
+    double Bx, By, Bz;
+};
+
+
+TEST(ABorisVelocityBatch, matchesScalarBorisVelocityToRoundOff)
+{
+    std::mt19937_64 gen(42);
+    std::uniform_real_distribution<double> dis(-2., 2.);
+
+    // the SIMD path is only compiled for the host CPU, i.e. in the test-pusher-native
+    // executable or with the native option: elsewhere this checks the scalar path only.
+    // Test full batches and partial ones, which go through the scalar tail
+    for (std::size_t count = 1; count <= BorisBatch::size; ++count)
+    {
+        BorisBatch batch;
+        std::vector<std::array<double, 3>> expected(count);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::array<double, 3> v{{dis(gen), dis(gen), dis(gen)}};
+            RandomFields fields{dis(gen), dis(gen), dis(gen), dis(gen), dis(gen), dis(gen)};
+            double coef = 0.01 * dis(gen);
+
+            batch.set(i, v, fields, coef);
+            expected[i] = borisVelocity(v, fields, coef);
+        }
+
+        borisVelocityBatch(batch, count);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto const v = batch.velocity(i);
+            for (std::size_t iComp = 0; iComp < 3; ++iComp)
+            {
+                EXPECT_NEAR(expected[i][iComp], v[iComp], 1e-14 * (1. + std::abs(v[iComp])));
+            }
+        }
+    }
+}
+
+
 TEST(APusherFactory, canReturnABorisPusher)
 {
     auto pusher = PusherFactory::makePusher<1, ParticleArray<1>::iterator, Electromag, Interpolator,
@@ -505,6 +865,16 @@ TEST(APusherFactory, canReturnABorisPusher)
 
 
 
+TEST(APusherFactory, canReturnAFusedBorisPusher)
+{
+    auto pusher = PusherFactory::makePusher<1, ParticleArray<1>::iterator, Electromag, Interpolator,
+                                            DummySelector, BoundaryCondition<1, 1>>("boris_fused");
+
+    EXPECT_NE(nullptr, pusher);
+}
+
+
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
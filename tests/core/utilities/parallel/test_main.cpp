@@ -0,0 +1,94 @@
+#include <atomic>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "utilities/parallel/parallel_for.h"
+#include "utilities/parallel/thread_pool.h"
+
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+
+using namespace PHARE;
+
+
+
+TEST(ParallelForChunks, visitsEachIndexOnce)
+{
+    std::size_t const size = 1000;
+    std::vector<int> visits(size, 0);
+
+    parallelForChunks(size, 7, [&](std::size_t first, std::size_t last, std::size_t) {
+        for (auto i = first; i < last; ++i)
+        {
+            ++visits[i];
+        }
+    });
+
+    EXPECT_EQ(std::vector<int>(size, 1), visits);
+}
+
+
+
+TEST(ParallelForChunks, rethrowsTheExceptionOfAChunk)
+{
+    auto throwInChunkTwo = [](std::size_t, std::size_t, std::size_t iChunk) {
+        if (iChunk == 2)
+        {
+            throw std::runtime_error("chunk 2");
+        }
+    };
+
+    EXPECT_THROW(parallelForChunks(100, 4, throwInChunkTwo), std::runtime_error);
+}
+
+
+
+TEST(AThreadPool, reusesItsWorkersAcrossLoops)
+{
+    ThreadPool pool;
+
+    std::atomic<std::size_t> nbrChunksRun{0};
+    auto runChunk = [&](std::size_t) { ++nbrChunksRun; };
+
+    pool.run(4, runChunk);
+    EXPECT_EQ(3u, pool.nbrWorkers());
+
+    for (int iLoop = 0; iLoop < 100; ++iLoop)
+    {
+        pool.run(4, runChunk);
+    }
+    pool.run(2, runChunk);
+
+    EXPECT_EQ(3u, pool.nbrWorkers());
+    EXPECT_EQ(4u * 101 + 2, nbrChunksRun.load());
+}
+
+
+
+TEST(AThreadPool, runsLoopsStartedFromAChunk)
+{
+    ThreadPool pool;
+
+    std::vector<std::size_t> sums(4, 0);
+
+    pool.run(4, [&](std::size_t iChunk) {
+        std::vector<std::size_t> values(8, 0);
+        pool.run(8, [&](std::size_t iValue) { values[iValue] = iValue; });
+        sums[iChunk] = std::accumulate(std::begin(values), std::end(values), std::size_t{0});
+    });
+
+    EXPECT_EQ(std::vector<std::size_t>(4, 28), sums);
+}
+
+
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
@@ -157,6 +157,27 @@ TEST_F(APartitionner, putsAllLeavingParticlesAtTheEnd)
 
 
 
+TEST_F(APartitionner, givesParticlesInSeveralBoxesToTheFirstOne)
+{
+    // this box contains both the right and the corner boxes
+    auto rightAndCorner = Box<int, 2>{Point<int, 2>{20, 0}, Point<int, 2>{21, 11}};
+    auto corner         = boundaryBoxes[2];
+
+    auto cornerFirst = partitionner(firstLeaving, std::end(particles),
+                                    std::vector<Box<int, 2>>{corner, rightAndCorner});
+    EXPECT_EQ(50, std::distance(cornerFirst[0], cornerFirst[1]));
+    EXPECT_TRUE(std::all_of(cornerFirst[0], cornerFirst[1], makeSelector(corner)));
+    EXPECT_EQ(50, std::distance(cornerFirst[1], cornerFirst[2]));
+
+    auto cornerLast = partitionner(firstLeaving, std::end(particles),
+                                   std::vector<Box<int, 2>>{rightAndCorner, corner});
+    EXPECT_EQ(100, std::distance(cornerLast[0], cornerLast[1]));
+    EXPECT_EQ(0, std::distance(cornerLast[1], cornerLast[2]));
+}
+
+
+
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,97 @@
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#include "utilities/random/philox.h"
+
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+
+using namespace PHARE;
+
+
+
+// known answers of Philox4x32-10 given with the Random123 library
+TEST(APhilox4x32, givesTheKnownAnswers)
+{
+    using counter = Philox4x32::counter_type;
+    using key     = Philox4x32::key_type;
+
+    counter const zeroAnswer{{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}};
+    counter const onesAnswer{{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}};
+    counter const piAnswer{{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}};
+
+    Philox4x32 const zeroGenerator{key{{0, 0}}};
+    Philox4x32 const onesGenerator{key{{0xffffffff, 0xffffffff}}};
+    Philox4x32 const piGenerator{key{{0xa4093822, 0x299f31d0}}};
+
+    EXPECT_EQ(zeroAnswer, zeroGenerator({{0, 0, 0, 0}}));
+    EXPECT_EQ(onesAnswer, onesGenerator({{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}}));
+    EXPECT_EQ(piAnswer, piGenerator({{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}}));
+}
+
+
+
+TEST(APhilox4x32, isKeyedByTheSeed)
+{
+    Philox4x32 const generator{std::uint64_t{0x299f31d0a4093822}};
+    Philox4x32 const sameGenerator{Philox4x32::key_type{{0xa4093822, 0x299f31d0}}};
+
+    Philox4x32::counter_type counter{{1, 2, 3, 4}};
+
+    EXPECT_EQ(sameGenerator(counter), generator(counter));
+    EXPECT_NE(Philox4x32{std::uint64_t{1}}(counter), generator(counter));
+}
+
+
+
+TEST(UniformNumbers, areInTheUnitInterval)
+{
+    EXPECT_EQ(0., uniformDouble(0, 0));
+    EXPECT_LT(uniformDouble(0xffffffff, 0xffffffff), 1.);
+    EXPECT_DOUBLE_EQ(0.5, uniformDouble(0x80000000, 0));
+
+    EXPECT_EQ(0.f, uniformFloat(0));
+    EXPECT_LT(uniformFloat(0xffffffff), 1.f);
+    EXPECT_FLOAT_EQ(0.5f, uniformFloat(0x80000000));
+}
+
+
+
+TEST(BoxMuller, givesNormalNumbersOfUnitVariance)
+{
+    Philox4x32 const generator{std::uint64_t{42}};
+
+    double sum        = 0.;
+    double sumSquares = 0.;
+
+    std::uint32_t const nbrDraws = 100000;
+    for (std::uint32_t iDraw = 0; iDraw < nbrDraws; ++iDraw)
+    {
+        auto const bits    = generator({{iDraw, 0, 0, 0}});
+        auto const normals = boxMuller(1. - uniformDouble(bits[0], bits[1]),
+                                       uniformDouble(bits[2], bits[3]));
+        for (auto normal : normals)
+        {
+            sum += normal;
+            sumSquares += normal * normal;
+        }
+    }
+
+    auto const mean     = sum / (2. * nbrDraws);
+    auto const variance = sumSquares / (2. * nbrDraws) - mean * mean;
+
+    EXPECT_NEAR(0., mean, 0.01);
+    EXPECT_NEAR(1., variance, 0.01);
+}
+
+
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}